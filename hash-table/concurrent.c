@@ -0,0 +1,721 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+
+/*
+ * Varianta thread-safe a hashtable-ului din hash-table.c. Tabela e impartita
+ * in segmente (lock striping): fiecare segment are propriile bucket-uri si
+ * propriul pthread_rwlock_t, deci thread-urile care lucreaza pe chei din
+ * segmente diferite nu se blocheaza intre ele, iar citirile din acelasi segment
+ * pot avea loc in paralel (read lock).
+ *
+ * Daca tabela e creata cu lockfree_reads, citirile nu mai iau deloc lock-ul:
+ * scriitorii publica intrarile noi atomic, iar intrarile scoase din tabela se
+ * elibereaza abia cand niciun cititor nu le mai poate vedea (epoch-based
+ * reclamation, vezi ht_epoch_*).
+ *
+ * Compilare: gcc concurrent.c -o concurrent.out -pthread
+ */
+
+#define HMAX 10
+#define NSEGMENTS 64 /* Putere a lui 2. */
+#define CACHE_LINE 64
+/* La cate intrari retrase incercam sa avansam epoca si sa eliberam memorie. */
+#define HT_RECLAIM_BATCH 64
+
+/* Citiri/scrieri ale pointerilor partajati cu cititorii fara lock. */
+#define LOAD(p)		atomic_load_explicit(&(p), memory_order_acquire)
+#define STORE(p, v)	atomic_store_explicit(&(p), (v), memory_order_release)
+
+typedef struct ht_entry_t ht_entry_t;
+struct ht_entry_t {
+	_Atomic(ht_entry_t *) next;
+	/* Hash-ul complet al cheii, comparat inaintea lui compare_function. */
+	unsigned int hash;
+	unsigned int key_size;
+	unsigned int value_size;
+	/* Cheia si valoarea sunt copiate in acelasi bloc, dupa structura. */
+	void *key;
+	void *value;
+};
+
+/*
+ * Array-ul de bucket-uri al unui segment, impreuna cu dimensiunea lui, ca un
+ * cititor fara lock sa nu vada niciodata un hmax nepotrivit cu array-ul.
+ */
+typedef struct ht_table_t ht_table_t;
+struct ht_table_t {
+	unsigned int hmax;
+	_Atomic(ht_entry_t *) buckets[];
+};
+
+typedef struct ht_segment_t ht_segment_t;
+struct ht_segment_t {
+	pthread_rwlock_t lock;
+	_Atomic(ht_table_t *) table;
+	unsigned int size; /* Nr. de intrari din segment. */
+} __attribute__((aligned(CACHE_LINE)));
+
+typedef struct hashtable_t hashtable_t;
+struct hashtable_t {
+	ht_segment_t *segments;
+	unsigned int nsegments;
+	int lockfree_reads;
+	/* (Pointer la) Functie pentru a calcula valoarea hash asociata cheilor. */
+	unsigned int (*hash_function)(void*);
+	/* (Pointer la) Functie pentru a compara doua chei. */
+	int (*compare_function)(void*, void*);
+};
+
+/*
+ * Functii de comparare a cheilor:
+ */
+int compare_function_ints(void *a, void *b)
+{
+	int int_a = *((int *)a);
+	int int_b = *((int *)b);
+
+	if (int_a == int_b) {
+		return 0;
+	} else if (int_a < int_b) {
+		return -1;
+	} else {
+		return 1;
+	}
+}
+
+int compare_function_strings(void *a, void *b)
+{
+	char *str_a = (char *)a;
+	char *str_b = (char *)b;
+
+	return strcmp(str_a, str_b);
+}
+
+/*
+ * Functii de hashing:
+ */
+unsigned int hash_function_int(void *a)
+{
+	/*
+	 * Credits: https://stackoverflow.com/a/12996028/7883884
+	 */
+	unsigned int uint_a = *((unsigned int *)a);
+
+	uint_a = ((uint_a >> 16u) ^ uint_a) * 0x45d9f3b;
+	uint_a = ((uint_a >> 16u) ^ uint_a) * 0x45d9f3b;
+	uint_a = (uint_a >> 16u) ^ uint_a;
+	return uint_a;
+}
+
+unsigned int hash_function_string(void *a)
+{
+	/*
+	 * Credits: http://www.cse.yorku.ca/~oz/hash.html
+	 */
+	unsigned char *puchar_a = (unsigned char*) a;
+	unsigned long hash = 5381;
+	int c;
+
+	while ((c = *puchar_a++))
+		hash = ((hash << 5u) + hash) + c; /* hash * 33 + c */
+
+	return hash;
+}
+
+/* ------------------------ Epoch-based reclamation ------------------------- */
+
+/*
+ * Fiecare thread care citeste fara lock are o inregistrare proprie (pe linia
+ * ei de cache), in care anunta epoca globala din momentul intrarii in sectiunea
+ * de citire. Memoria retrasa in epoca E se elibereaza abia dupa ce epoca
+ * globala a avansat de doua ori, adica dupa ce toti cititorii activi au trecut
+ * prin epoci mai noi si nu mai pot tine pointeri spre ea.
+ */
+typedef struct ht_epoch_rec_t ht_epoch_rec_t;
+struct ht_epoch_rec_t {
+	/* 0 daca thread-ul nu citeste, altfel (epoca << 1) | 1. */
+	_Atomic unsigned long state;
+	/* 1 cat timp un thread foloseste inregistrarea. */
+	_Atomic int in_use;
+	ht_epoch_rec_t *next;
+} __attribute__((aligned(CACHE_LINE)));
+
+typedef struct ht_retired_t ht_retired_t;
+struct ht_retired_t {
+	void *ptr;
+	ht_retired_t *next;
+};
+
+static _Atomic unsigned long ht_epoch = 1;
+static _Atomic(ht_epoch_rec_t *) ht_epoch_recs;
+static __thread ht_epoch_rec_t *ht_my_rec;
+static pthread_key_t ht_epoch_key;
+static pthread_once_t ht_epoch_once = PTHREAD_ONCE_INIT;
+
+/* Listele de memorie retrasa, cate una pentru fiecare din ultimele 3 epoci. */
+static pthread_mutex_t ht_limbo_lock = PTHREAD_MUTEX_INITIALIZER;
+static ht_retired_t *ht_limbo[3];
+static unsigned int ht_limbo_count;
+
+/*
+ * La terminarea unui thread inregistrarea lui devine libera si poate fi
+ * refolosita de un thread nou, deci lista nu creste la nesfarsit.
+ */
+static void ht_epoch_release_rec(void *data)
+{
+    ht_epoch_rec_t *rec = data;
+
+    atomic_store(&rec->state, 0);
+    atomic_store(&rec->in_use, 0);
+}
+
+static void ht_epoch_init_key(void)
+{
+    pthread_key_create(&ht_epoch_key, ht_epoch_release_rec);
+}
+
+static ht_epoch_rec_t *ht_epoch_register(void)
+{
+    ht_epoch_rec_t *rec;
+
+    pthread_once(&ht_epoch_once, ht_epoch_init_key);
+    for (rec = atomic_load(&ht_epoch_recs); rec != NULL; rec = rec->next) {
+        int expected = 0;
+        if (atomic_compare_exchange_strong(&rec->in_use, &expected, 1))
+            break;
+    }
+
+    if (rec == NULL) {
+        rec = aligned_alloc(CACHE_LINE, sizeof(ht_epoch_rec_t));
+        atomic_init(&rec->state, 0);
+        atomic_init(&rec->in_use, 1);
+        rec->next = atomic_load(&ht_epoch_recs);
+        while (!atomic_compare_exchange_weak(&ht_epoch_recs, &rec->next, rec))
+            ;
+    }
+
+    pthread_setspecific(ht_epoch_key, rec);
+    return rec;
+}
+
+static void ht_epoch_enter(void)
+{
+    if (ht_my_rec == NULL)
+        ht_my_rec = ht_epoch_register();
+
+    unsigned long epoch = atomic_load_explicit(&ht_epoch, memory_order_relaxed);
+    atomic_store_explicit(&ht_my_rec->state, (epoch << 1) | 1,
+                          memory_order_relaxed);
+    /* Anuntul trebuie sa fie vizibil inainte sa citim vreun pointer. */
+    atomic_thread_fence(memory_order_seq_cst);
+}
+
+static void ht_epoch_exit(void)
+{
+    atomic_store_explicit(&ht_my_rec->state, 0, memory_order_release);
+}
+
+static void ht_free_retired(ht_retired_t *node)
+{
+    while (node != NULL) {
+        ht_retired_t *next = node->next;
+        free(node->ptr);
+        free(node);
+        node = next;
+    }
+}
+
+/*
+ * Avanseaza epoca globala daca toti cititorii activi au anuntat-o deja pe cea
+ * curenta si elibereaza ce a fost retras acum doua epoci. Se apeleaza cu
+ * ht_limbo_lock luat.
+ */
+static void ht_epoch_try_advance(void)
+{
+    unsigned long epoch = atomic_load(&ht_epoch);
+
+    atomic_thread_fence(memory_order_seq_cst);
+    for (ht_epoch_rec_t *rec = atomic_load(&ht_epoch_recs); rec != NULL;
+         rec = rec->next) {
+        unsigned long state = atomic_load(&rec->state);
+        if ((state & 1) && (state >> 1) != epoch)
+            return;
+    }
+
+    atomic_store(&ht_epoch, epoch + 1);
+    ht_free_retired(ht_limbo[(epoch + 1) % 3]);
+    ht_limbo[(epoch + 1) % 3] = NULL;
+}
+
+/*
+ * Pune ptr deoparte pana cand niciun cititor nu il mai poate vedea.
+ */
+static void ht_epoch_retire(void *ptr)
+{
+    ht_retired_t *node = malloc(sizeof(ht_retired_t));
+
+    node->ptr = ptr;
+    pthread_mutex_lock(&ht_limbo_lock);
+    unsigned long epoch = atomic_load(&ht_epoch);
+    node->next = ht_limbo[epoch % 3];
+    ht_limbo[epoch % 3] = node;
+    if (++ht_limbo_count % HT_RECLAIM_BATCH == 0)
+        ht_epoch_try_advance();
+    pthread_mutex_unlock(&ht_limbo_lock);
+}
+
+/* ------------------------------ Hashtable -------------------------------- */
+
+/*
+ * Segmentul unei chei se alege din bitii de sus ai hash-ului amestecat, iar
+ * bucket-ul din segment cu hash % hmax, ca cele doua sa nu fie corelate.
+ */
+static ht_segment_t *ht_segment(hashtable_t *ht, unsigned int hash)
+{
+    unsigned int mixed = hash * 2654435769u;
+
+    return &ht->segments[(mixed >> 16) & (ht->nsegments - 1)];
+}
+
+static ht_table_t *ht_table_create(unsigned int hmax)
+{
+    ht_table_t *table = calloc(1, sizeof(ht_table_t) +
+                               hmax * sizeof(_Atomic(ht_entry_t *)));
+
+    table->hmax = hmax;
+    return table;
+}
+
+/*
+ * Functie apelata pentru a crea un hashtable cu nsegments segmente (rotunjit
+ * la o putere a lui 2), fiecare avand initial hmax bucket-uri. Daca
+ * lockfree_reads != 0, ht_get si ht_has_key nu iau lock-uri.
+ */
+hashtable_t *ht_create(unsigned int hmax, unsigned int nsegments,
+		int lockfree_reads, unsigned int (*hash_function)(void*),
+		int (*compare_function)(void*, void*))
+{
+    hashtable_t *table = malloc(sizeof(hashtable_t));
+    unsigned int n = 1;
+
+    while (n < nsegments)
+        n <<= 1;
+
+    table->nsegments = n;
+    table->segments = aligned_alloc(CACHE_LINE, n * sizeof(ht_segment_t));
+    for (unsigned int i = 0; i < n; ++i) {
+        ht_segment_t *seg = &table->segments[i];
+        pthread_rwlock_init(&seg->lock, NULL);
+        atomic_init(&seg->table, ht_table_create(hmax));
+        seg->size = 0;
+    }
+
+    table->lockfree_reads = lockfree_reads;
+    table->hash_function = hash_function;
+    table->compare_function = compare_function;
+
+    return table;
+}
+
+/*
+ * Cauta cheia in segment. Apelantul tine lock-ul segmentului sau este intr-o
+ * sectiune de citire (ht_epoch_enter).
+ */
+static ht_entry_t *ht_find(hashtable_t *ht, ht_segment_t *seg, void *key,
+	unsigned int hash)
+{
+    ht_table_t *table = LOAD(seg->table);
+    ht_entry_t *entry = LOAD(table->buckets[hash % table->hmax]);
+
+    while (entry != NULL) {
+        if (entry->hash == hash && ht->compare_function(key, entry->key) == 0)
+            return entry;
+        entry = LOAD(entry->next);
+    }
+
+    return NULL;
+}
+
+/*
+ * Aloca o intrare cu cheia si valoarea copiate in acelasi bloc.
+ */
+static ht_entry_t *ht_entry_create(void *key, unsigned int key_size,
+	void *value, unsigned int value_size, unsigned int hash)
+{
+    unsigned int value_off = (key_size + 7) & ~7u;
+    ht_entry_t *entry = malloc(sizeof(ht_entry_t) + value_off + value_size);
+
+    entry->hash = hash;
+    entry->key_size = key_size;
+    entry->value_size = value_size;
+    entry->key = entry + 1;
+    entry->value = (char *)(entry + 1) + value_off;
+    memcpy(entry->key, key, key_size);
+    memcpy(entry->value, value, value_size);
+    atomic_init(&entry->next, NULL);
+
+    return entry;
+}
+
+/*
+ * Elibereaza o intrare scoasa din tabela. Cu cititori fara lock, cineva poate
+ * inca parcurge intrarea, deci eliberarea se amana.
+ */
+static void ht_entry_release(hashtable_t *ht, ht_entry_t *entry)
+{
+    if (entry == NULL)
+        return;
+
+    if (ht->lockfree_reads)
+        ht_epoch_retire(entry);
+    else
+        free(entry);
+}
+
+/*
+ * Dubleaza numarul de bucket-uri ale unui segment. Apelantul tine lock-ul de
+ * scriere; se blocheaza doar segmentul respectiv, nu toata tabela.
+ *
+ * Cu lock-uri, nodurile sunt doar reinlantuite. Cu cititori fara lock, un
+ * cititor poate fi oriunde in lanturile vechi, deci se construiesc copii ale
+ * intrarilor in tabela noua, care e publicata dintr-o singura scriere, iar
+ * tabela si intrarile vechi sunt retrase.
+ */
+static void ht_segment_grow(hashtable_t *ht, ht_segment_t *seg)
+{
+    ht_table_t *old = LOAD(seg->table);
+    ht_table_t *table = ht_table_create(old->hmax * 2);
+
+    for (unsigned int i = 0; i < old->hmax; ++i) {
+        ht_entry_t *entry = LOAD(old->buckets[i]);
+        while (entry != NULL) {
+            ht_entry_t *next = LOAD(entry->next);
+            ht_entry_t *moved = entry;
+            unsigned int index = entry->hash % table->hmax;
+
+            if (ht->lockfree_reads)
+                moved = ht_entry_create(entry->key, entry->key_size,
+                                        entry->value, entry->value_size,
+                                        entry->hash);
+            atomic_store_explicit(&moved->next, LOAD(table->buckets[index]),
+                                  memory_order_relaxed);
+            atomic_store_explicit(&table->buckets[index], moved,
+                                  memory_order_relaxed);
+            entry = next;
+        }
+    }
+
+    STORE(seg->table, table);
+
+    if (ht->lockfree_reads) {
+        for (unsigned int i = 0; i < old->hmax; ++i) {
+            ht_entry_t *entry = LOAD(old->buckets[i]);
+            while (entry != NULL) {
+                ht_entry_t *next = LOAD(entry->next);
+                ht_epoch_retire(entry);
+                entry = next;
+            }
+        }
+        ht_epoch_retire(old);
+    } else {
+        free(old);
+    }
+}
+
+/*
+ * Functie care intoarce 1 daca cheia exista in hashtable, 0 altfel.
+ */
+int ht_has_key(hashtable_t *ht, void *key)
+{
+    unsigned int hash = ht->hash_function(key);
+    ht_segment_t *seg = ht_segment(ht, hash);
+    int found;
+
+    if (ht->lockfree_reads) {
+        ht_epoch_enter();
+        found = ht_find(ht, seg, key, hash) != NULL;
+        ht_epoch_exit();
+        return found;
+    }
+
+    pthread_rwlock_rdlock(&seg->lock);
+    found = ht_find(ht, seg, key, hash) != NULL;
+    pthread_rwlock_unlock(&seg->lock);
+
+    return found;
+}
+
+/*
+ * Atentie! Spre deosebire de varianta single-thread, ht_get nu poate intoarce
+ * un pointer spre valoare, pentru ca alt thread o poate sterge imediat dupa.
+ * Valoarea (cel mult value_size octeti) se copiaza in value, sub read lock
+ * sau in sectiunea de citire fara lock. Intoarce 1 daca cheia a fost gasita
+ * si 0 altfel.
+ */
+int ht_get(hashtable_t *ht, void *key, void *value, unsigned int value_size)
+{
+    unsigned int hash = ht->hash_function(key);
+    ht_segment_t *seg = ht_segment(ht, hash);
+
+    if (ht->lockfree_reads)
+        ht_epoch_enter();
+    else
+        pthread_rwlock_rdlock(&seg->lock);
+
+    ht_entry_t *entry = ht_find(ht, seg, key, hash);
+    if (entry != NULL) {
+        if (value_size > entry->value_size)
+            value_size = entry->value_size;
+        memcpy(value, entry->value, value_size);
+    }
+
+    if (ht->lockfree_reads)
+        ht_epoch_exit();
+    else
+        pthread_rwlock_unlock(&seg->lock);
+
+    return entry != NULL;
+}
+
+/*
+ * La fel ca in varianta single-thread, cheia si valoarea se copiaza. Intrarea
+ * noua se aloca inainte de a lua lock-ul, ca sectiunea critica sa fie scurta,
+ * si e complet initializata inainte sa fie publicata, deci un cititor fara
+ * lock o vede fie intreaga, fie deloc.
+ */
+void ht_put(hashtable_t *ht, void *key, unsigned int key_size,
+	void *value, unsigned int value_size)
+{
+    unsigned int hash = ht->hash_function(key);
+    ht_segment_t *seg = ht_segment(ht, hash);
+    ht_entry_t *new_entry = ht_entry_create(key, key_size, value, value_size,
+                                            hash);
+    ht_entry_t *old = NULL;
+
+    pthread_rwlock_wrlock(&seg->lock);
+    ht_table_t *table = LOAD(seg->table);
+    _Atomic(ht_entry_t *) *head = &table->buckets[hash % table->hmax];
+    _Atomic(ht_entry_t *) *link = head;
+    while (LOAD(*link) != NULL) {
+        ht_entry_t *entry = LOAD(*link);
+        if (entry->hash == hash && ht->compare_function(key, entry->key) == 0) {
+            old = entry;
+            break;
+        }
+        link = &entry->next;
+    }
+
+    if (old != NULL) {
+        /* Inlocuim intrarea, pentru ca valoarea noua poate avea alta marime. */
+        atomic_store_explicit(&new_entry->next, LOAD(old->next),
+                              memory_order_relaxed);
+        STORE(*link, new_entry);
+    } else {
+        atomic_store_explicit(&new_entry->next, LOAD(*head),
+                              memory_order_relaxed);
+        STORE(*head, new_entry);
+        seg->size++;
+        if (seg->size > table->hmax)
+            ht_segment_grow(ht, seg);
+    }
+    pthread_rwlock_unlock(&seg->lock);
+
+    ht_entry_release(ht, old);
+}
+
+/*
+ * Procedura care elimina din hashtable intrarea asociata cheii key.
+ */
+void ht_remove_entry(hashtable_t *ht, void *key)
+{
+    unsigned int hash = ht->hash_function(key);
+    ht_segment_t *seg = ht_segment(ht, hash);
+    ht_entry_t *removed = NULL;
+
+    pthread_rwlock_wrlock(&seg->lock);
+    ht_table_t *table = LOAD(seg->table);
+    _Atomic(ht_entry_t *) *link = &table->buckets[hash % table->hmax];
+    while (LOAD(*link) != NULL) {
+        ht_entry_t *entry = LOAD(*link);
+        if (entry->hash == hash && ht->compare_function(key, entry->key) == 0) {
+            removed = entry;
+            /* removed->next ramane valid pentru cititorii aflati pe el. */
+            STORE(*link, LOAD(removed->next));
+            seg->size--;
+            break;
+        }
+        link = &entry->next;
+    }
+    pthread_rwlock_unlock(&seg->lock);
+
+    ht_entry_release(ht, removed);
+}
+
+/*
+ * Procedura care elibereaza toata memoria hashtable-ului. Nu trebuie apelata
+ * cat timp alte thread-uri inca folosesc tabela.
+ */
+void ht_free(hashtable_t *ht)
+{
+    for (unsigned int i = 0; i < ht->nsegments; ++i) {
+        ht_segment_t *seg = &ht->segments[i];
+        ht_table_t *table = LOAD(seg->table);
+        for (unsigned int j = 0; j < table->hmax; ++j) {
+            ht_entry_t *entry = LOAD(table->buckets[j]);
+            while (entry != NULL) {
+                ht_entry_t *next = LOAD(entry->next);
+                free(entry);
+                entry = next;
+            }
+        }
+        free(table);
+        pthread_rwlock_destroy(&seg->lock);
+    }
+
+    /*
+     * Listele de memorie retrasa sunt comune tuturor tabelelor, deci nu le
+     * golim fortat: trei avansari reusite elibereaza tot ce e retras, iar daca
+     * alte tabele au cititori activi, restul se elibereaza mai tarziu.
+     */
+    pthread_mutex_lock(&ht_limbo_lock);
+    for (int i = 0; i < 3; ++i)
+        ht_epoch_try_advance();
+    pthread_mutex_unlock(&ht_limbo_lock);
+
+    free(ht->segments);
+    free(ht);
+}
+
+/*
+ * Nr. total de intrari. Segmentele se citesc pe rand, deci cu alte thread-uri
+ * active rezultatul e doar aproximativ.
+ */
+unsigned int ht_get_size(hashtable_t *ht)
+{
+    unsigned int size = 0;
+
+    if (ht == NULL)
+        return 0;
+
+    for (unsigned int i = 0; i < ht->nsegments; ++i) {
+        pthread_rwlock_rdlock(&ht->segments[i].lock);
+        size += ht->segments[i].size;
+        pthread_rwlock_unlock(&ht->segments[i].lock);
+    }
+
+    return size;
+}
+
+/* ------------------------------- Benchmark -------------------------------- */
+
+struct bench_arg {
+	hashtable_t *ht;
+	pthread_barrier_t *barrier;
+	unsigned int seed;
+	unsigned int nkeys;
+	unsigned int ops;
+	unsigned int read_pct;
+};
+
+static double now_sec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void *bench_worker(void *data)
+{
+    struct bench_arg *arg = data;
+    unsigned int x = arg->seed;
+    int value;
+
+    pthread_barrier_wait(arg->barrier);
+    for (unsigned int i = 0; i < arg->ops; ++i) {
+        /* xorshift32: ieftin si fara stare partajata, spre deosebire de rand */
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        int key = x % arg->nkeys;
+
+        if (x % 100 < arg->read_pct) {
+            ht_get(arg->ht, &key, &value, sizeof(value));
+        } else {
+            value = i;
+            ht_put(arg->ht, &key, sizeof(key), &value, sizeof(value));
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * Ruleaza threads thread-uri care fac cate ops operatii pe o tabela cu nkeys
+ * chei si intoarce debitul total in milioane de operatii pe secunda.
+ */
+static double bench_run(unsigned int nsegments, int lockfree_reads,
+	unsigned int threads, unsigned int nkeys, unsigned int ops,
+	unsigned int read_pct)
+{
+    hashtable_t *ht = ht_create(HMAX, nsegments, lockfree_reads,
+                                hash_function_int, compare_function_ints);
+    pthread_t *tids = malloc(threads * sizeof(pthread_t));
+    struct bench_arg *args = malloc(threads * sizeof(struct bench_arg));
+    pthread_barrier_t barrier;
+
+    for (unsigned int i = 0; i < nkeys; ++i) {
+        int key = i;
+        ht_put(ht, &key, sizeof(key), &key, sizeof(key));
+    }
+
+    pthread_barrier_init(&barrier, NULL, threads + 1);
+    for (unsigned int t = 0; t < threads; ++t) {
+        args[t] = (struct bench_arg){ht, &barrier, 2463534242u + t * 7919,
+                                     nkeys, ops, read_pct};
+        pthread_create(&tids[t], NULL, bench_worker, &args[t]);
+    }
+
+    pthread_barrier_wait(&barrier);
+    double start = now_sec();
+    for (unsigned int t = 0; t < threads; ++t)
+        pthread_join(tids[t], NULL);
+    double elapsed = now_sec() - start;
+
+    pthread_barrier_destroy(&barrier);
+    free(args);
+    free(tids);
+    ht_free(ht);
+
+    return (double)threads * ops / elapsed / 1e6;
+}
+
+int main()
+{
+    unsigned int max_threads, nkeys, ops, read_pct;
+
+    /*
+     * Intrare: nr. maxim de thread-uri, nr. de chei, operatii per thread si
+     * procentul de citiri. Se compara un singur lock global (1 segment),
+     * NSEGMENTS segmente cu read lock si NSEGMENTS segmente cu citiri fara
+     * lock, pentru 1, 2, 4, ... max_threads thread-uri.
+     */
+    if (scanf("%u %u %u %u", &max_threads, &nkeys, &ops, &read_pct) != 4)
+        return 1;
+
+    printf("threads | global lock Mops/s | %u segments Mops/s | "
+           "lock-free reads Mops/s\n", NSEGMENTS);
+    for (unsigned int t = 1; t <= max_threads; t *= 2) {
+        double global = bench_run(1, 0, t, nkeys, ops, read_pct);
+        double striped = bench_run(NSEGMENTS, 0, t, nkeys, ops, read_pct);
+        double lockfree = bench_run(NSEGMENTS, 1, t, nkeys, ops, read_pct);
+        printf("%7u | %18.2f | %18.2f | %22.2f\n", t, global, striped,
+               lockfree);
+    }
+
+    return 0;
+}
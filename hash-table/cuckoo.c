@@ -0,0 +1,703 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MAX_STRING_SIZE	256
+#define HMAX 10
+
+/*
+ * Varianta cu hashing cuckoo a hashtable-ului din hash-table.c, cu aceeasi
+ * interfata (ht_create/ht_put/ht_get/ht_has_key/ht_remove_entry/ht_free).
+ * Fiecare cheie poate sta doar in unul din cele doua bucket-uri ale ei (cate
+ * unul pentru fiecare functie de hash), fiecare cu HT_BUCKET_SLOTS sloturi,
+ * sau intr-un stash mic de HT_STASH_SIZE intrari. O cautare verifica deci cel
+ * mult 2 * HT_BUCKET_SLOTS + HT_STASH_SIZE sloturi, indiferent cat de plina
+ * sau de "ghinionista" e tabela: costul in cel mai rau caz e O(1), nu doar in
+ * medie ca la lanturi.
+ *
+ * Inserarea muta, la nevoie, intrari din bucket-urile pline in bucket-ul lor
+ * alternativ (drum aleator de cel mult HT_MAX_KICKS mutari). Daca drumul nu se
+ * termina, intrarea ramasa merge in stash; daca si stash-ul e plin, tabela se
+ * reconstruieste cu dublul bucket-urilor (de cel mult HT_MAX_REBUILDS ori).
+ * Ambele bucket-uri se calculeaza din acelasi hash pe 32 de biti (interfata nu
+ * da lungimea cheii, deci cheia nu poate fi hash-uita a doua oara), asa ca
+ * mai mult de 2 * HT_BUCKET_SLOTS + HT_STASH_SIZE chei cu acelasi hash nu au
+ * loc nicaieri: ht_put le refuza (intoarce -1) in loc sa tot mareasca tabela.
+ */
+
+#define HT_BUCKET_SLOTS 4
+#define HT_STASH_SIZE 8
+#define HT_MAX_KICKS 256
+/* De cate ori se dubleaza tabela la o reconstruire inainte ca ht_put sa esueze. */
+#define HT_MAX_REBUILDS 4
+/* Factorul de incarcare maxim (din totalul sloturilor), ca fractie: 9/10. */
+#define HT_LOAD_NUM 9
+#define HT_LOAD_DEN 10
+
+typedef struct info info;
+struct info {
+	void *key;
+	void *value;
+};
+
+typedef struct ht_slot_t ht_slot_t;
+struct ht_slot_t {
+	/* Hash-ul complet al cheii; din el se calculeaza ambele bucket-uri. */
+	unsigned int hash;
+	info entry; /* entry.key == NULL inseamna slot liber. */
+};
+
+/*
+ * Sloturile unui bucket sunt consecutive in memorie, deci verificarea lor
+ * atinge una sau doua linii de cache.
+ */
+typedef struct ht_bucket_t ht_bucket_t;
+struct ht_bucket_t {
+	ht_slot_t slots[HT_BUCKET_SLOTS];
+};
+
+typedef struct hashtable_t hashtable_t;
+struct hashtable_t {
+	ht_bucket_t *buckets;
+	unsigned int nbuckets; /* Putere a lui 2, cel putin 2. */
+	unsigned int shift; /* 32 - log2(nbuckets). */
+	/* Nr. total de intrari existente curent in tabela (inclusiv stash). */
+	unsigned int size;
+	ht_slot_t stash[HT_STASH_SIZE];
+	unsigned int stash_size;
+	unsigned int rng; /* Starea generatorului pentru alegerea victimelor. */
+	/* Statistici: mutari facute la inserari si reconstruiri ale tabelei. */
+	unsigned long kicks;
+	unsigned long rebuilds;
+	/* (Pointer la) Functie pentru a calcula valoarea hash asociata cheilor. */
+	unsigned int (*hash_function)(void*);
+	/* (Pointer la) Functie pentru a compara doua chei. */
+	int (*compare_function)(void*, void*);
+	/* (Pointer la) Functie pentru a elibera memoria ocupata de cheie si valoare. */
+	void (*key_val_free_function)(void*);
+};
+
+/*
+ * Functii de comparare a cheilor:
+ */
+int compare_function_ints(void *a, void *b)
+{
+	int int_a = *((int *)a);
+	int int_b = *((int *)b);
+
+	if (int_a == int_b) {
+		return 0;
+	} else if (int_a < int_b) {
+		return -1;
+	} else {
+		return 1;
+	}
+}
+
+int compare_function_strings(void *a, void *b)
+{
+	char *str_a = (char *)a;
+	char *str_b = (char *)b;
+
+	return strcmp(str_a, str_b);
+}
+
+/*
+ * Functii de hashing:
+ */
+unsigned int hash_function_int(void *a)
+{
+	/*
+	 * Credits: https://stackoverflow.com/a/12996028/7883884
+	 */
+	unsigned int uint_a = *((unsigned int *)a);
+
+	uint_a = ((uint_a >> 16u) ^ uint_a) * 0x45d9f3b;
+	uint_a = ((uint_a >> 16u) ^ uint_a) * 0x45d9f3b;
+	uint_a = (uint_a >> 16u) ^ uint_a;
+	return uint_a;
+}
+
+unsigned int hash_function_string(void *a)
+{
+	/*
+	 * Credits: http://www.cse.yorku.ca/~oz/hash.html
+	 */
+	unsigned char *puchar_a = (unsigned char*) a;
+	unsigned long hash = 5381;
+	int c;
+
+	while ((c = *puchar_a++))
+		hash = ((hash << 5u) + hash) + c; /* hash * 33 + c */
+
+	return hash;
+}
+
+/*
+ * Functie apelata pentru a elibera memoria ocupata de cheia si valoarea unei
+ * intrari. Structura info traieste in slot, iar cheia si valoarea sunt alocate
+ * intr-un singur bloc care incepe cu cheia, deci e suficient un singur free.
+ */
+void key_val_free_function(void *data) {
+
+    if (!data)
+        return;
+    info *information = (info*) data;
+
+    free(information->key);
+    information->key = NULL;
+    information->value = NULL;
+}
+
+/*
+ * Cele doua bucket-uri ale unui hash. Primul foloseste hashing Fibonacci
+ * (bitii de sus ai lui hash * 2^32 / phi), al doilea bitii de sus ai unui
+ * amestec diferit al aceluiasi hash. Daca ies egale, al doilea e vecinul
+ * primului, ca o cheie sa aiba mereu doua bucket-uri distincte.
+ */
+static inline unsigned int ht_bucket1(hashtable_t *ht, unsigned int hash)
+{
+    return (unsigned int)(hash * 2654435769u) >> ht->shift;
+}
+
+static inline unsigned int ht_bucket2(hashtable_t *ht, unsigned int hash)
+{
+    unsigned int h = hash ^ 0x5bd1e995u;
+
+    h = (h ^ (h >> 16)) * 0x85ebca6bu;
+    h = (h ^ (h >> 13)) * 0xc2b2ae35u;
+    h ^= h >> 16;
+
+    unsigned int b = h >> ht->shift;
+    unsigned int b1 = ht_bucket1(ht, hash);
+    return b != b1 ? b : b1 ^ 1;
+}
+
+/*
+ * xorshift32: suficient pentru a alege ce intrare se muta dintr-un bucket.
+ */
+static inline unsigned int ht_rand(hashtable_t *ht)
+{
+    unsigned int x = ht->rng;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    ht->rng = x;
+    return x;
+}
+
+static void ht_alloc_buckets(hashtable_t *ht, unsigned int nbuckets)
+{
+    unsigned int log2 = 1;
+
+    while ((1u << log2) < nbuckets)
+        log2++;
+
+    ht->nbuckets = 1u << log2;
+    ht->shift = 32 - log2;
+    ht->buckets = calloc(ht->nbuckets, sizeof(ht_bucket_t));
+}
+
+static ht_slot_t *ht_find_slot(hashtable_t *ht, void *key, unsigned int hash)
+{
+    ht_bucket_t *b1 = &ht->buckets[ht_bucket1(ht, hash)];
+    ht_bucket_t *b2 = &ht->buckets[ht_bucket2(ht, hash)];
+
+    for (int i = 0; i < HT_BUCKET_SLOTS; ++i) {
+        ht_slot_t *slot = &b1->slots[i];
+        if (slot->entry.key != NULL && slot->hash == hash &&
+            ht->compare_function(key, slot->entry.key) == 0)
+            return slot;
+    }
+
+    for (int i = 0; i < HT_BUCKET_SLOTS; ++i) {
+        ht_slot_t *slot = &b2->slots[i];
+        if (slot->entry.key != NULL && slot->hash == hash &&
+            ht->compare_function(key, slot->entry.key) == 0)
+            return slot;
+    }
+
+    for (unsigned int i = 0; i < ht->stash_size; ++i) {
+        ht_slot_t *slot = &ht->stash[i];
+        if (slot->hash == hash &&
+            ht->compare_function(key, slot->entry.key) == 0)
+            return slot;
+    }
+
+    return NULL;
+}
+
+/*
+ * Pune slotul intr-un loc liber din bucket-ul b, daca exista.
+ */
+static int ht_place_in(hashtable_t *ht, unsigned int b, ht_slot_t *slot)
+{
+    for (int i = 0; i < HT_BUCKET_SLOTS; ++i) {
+        if (ht->buckets[b].slots[i].entry.key == NULL) {
+            ht->buckets[b].slots[i] = *slot;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static inline void ht_swap_slots(ht_slot_t *a, ht_slot_t *b)
+{
+    ht_slot_t tmp = *a;
+
+    *a = *b;
+    *b = tmp;
+}
+
+/*
+ * Insereaza slotul (a carui cheie nu exista in tabela). Daca ambele bucket-uri
+ * sunt pline, muta o intrare aleasa aleator din bucket in bucket-ul ei
+ * alternativ, de cel mult HT_MAX_KICKS ori; intrarea ramasa la final merge in
+ * stash. Intoarce 0 doar daca si stash-ul e plin; atunci mutarile se anuleaza
+ * in ordine inversa, deci tabela si *slot raman exact ca inainte de apel.
+ */
+static int ht_insert_slot(hashtable_t *ht, ht_slot_t *slot)
+{
+    ht_slot_t *path[HT_MAX_KICKS];
+    unsigned int b = ht_bucket1(ht, slot->hash);
+    int kicks;
+
+    if (ht_place_in(ht, b, slot) ||
+        ht_place_in(ht, ht_bucket2(ht, slot->hash), slot))
+        return 1;
+
+    for (kicks = 0; kicks < HT_MAX_KICKS; ++kicks) {
+        ht_slot_t *victim = &ht->buckets[b].slots[ht_rand(ht) % HT_BUCKET_SLOTS];
+
+        ht_swap_slots(victim, slot);
+        path[kicks] = victim;
+        ht->kicks++;
+
+        /* Intrarea scoasa merge in celalalt bucket al ei. */
+        unsigned int b1 = ht_bucket1(ht, slot->hash);
+        b = b == b1 ? ht_bucket2(ht, slot->hash) : b1;
+        if (ht_place_in(ht, b, slot))
+            return 1;
+    }
+
+    if (ht->stash_size < HT_STASH_SIZE) {
+        ht->stash[ht->stash_size++] = *slot;
+        return 1;
+    }
+
+    while (kicks-- > 0)
+        ht_swap_slots(path[kicks], slot);
+
+    return 0;
+}
+
+/*
+ * Reconstruieste tabela cu cel putin nbuckets bucket-uri, dublandu-le (de cel
+ * mult HT_MAX_REBUILDS ori) pana cand toate intrarile (inclusiv cele din stash
+ * si, daca exista, extra) incap. Intoarce 1 la succes; altfel tabela ramane
+ * neschimbata (fara extra) si intoarce 0.
+ */
+static int ht_rebuild(hashtable_t *ht, unsigned int nbuckets,
+	const ht_slot_t *extra)
+{
+    ht_slot_t *all = malloc((ht->size + 1) * sizeof(ht_slot_t));
+    unsigned int n = 0;
+
+    if (extra != NULL)
+        all[n++] = *extra;
+
+    for (unsigned int b = 0; b < ht->nbuckets; ++b) {
+        for (int i = 0; i < HT_BUCKET_SLOTS; ++i) {
+            if (ht->buckets[b].slots[i].entry.key != NULL)
+                all[n++] = ht->buckets[b].slots[i];
+        }
+    }
+    for (unsigned int i = 0; i < ht->stash_size; ++i)
+        all[n++] = ht->stash[i];
+
+    ht_bucket_t *old_buckets = ht->buckets;
+    unsigned int old_nbuckets = ht->nbuckets, old_shift = ht->shift;
+    unsigned int old_stash_size = ht->stash_size;
+    ht_slot_t old_stash[HT_STASH_SIZE];
+    memcpy(old_stash, ht->stash, sizeof(old_stash));
+
+    for (int attempt = 0; attempt < HT_MAX_REBUILDS; ++attempt) {
+        unsigned int i = 0;
+
+        ht_alloc_buckets(ht, nbuckets);
+        ht->stash_size = 0;
+        if (ht->buckets == NULL)
+            break;
+        for (i = 0; i < n; ++i) {
+            ht_slot_t slot = all[i];
+            if (!ht_insert_slot(ht, &slot))
+                break;
+        }
+        if (i == n) {
+            free(old_buckets);
+            free(all);
+            ht->rebuilds++;
+            return 1;
+        }
+
+        free(ht->buckets);
+        nbuckets = 2 * ht->nbuckets;
+    }
+
+    ht->buckets = old_buckets;
+    ht->nbuckets = old_nbuckets;
+    ht->shift = old_shift;
+    ht->stash_size = old_stash_size;
+    memcpy(ht->stash, old_stash, sizeof(old_stash));
+    free(all);
+    return 0;
+}
+
+/*
+ * Functie apelata dupa alocarea unui hashtable pentru a-l initializa.
+ * hmax (nr. de intrari asteptate) este impartit la HT_BUCKET_SLOTS si rotunjit
+ * in sus la o putere a lui 2.
+ */
+hashtable_t *ht_create(unsigned int hmax, unsigned int (*hash_function)(void*),
+		int (*compare_function)(void*, void*),
+		void (*key_val_free_function)(void*))
+{
+    hashtable_t *table = malloc(sizeof(hashtable_t));
+
+    ht_alloc_buckets(table, (hmax + HT_BUCKET_SLOTS - 1) / HT_BUCKET_SLOTS);
+    table->size = 0;
+    table->stash_size = 0;
+    table->rng = 2463534242u;
+    table->kicks = 0;
+    table->rebuilds = 0;
+
+    table->key_val_free_function = key_val_free_function;
+    table->hash_function = hash_function;
+    table->compare_function = compare_function;
+
+    return table;
+}
+
+/*
+ * Functie care intoarce:
+ * 1, daca pentru cheia key a fost asociata anterior o valoare in hashtable
+ * folosind functia put;
+ * 0, altfel.
+ */
+int ht_has_key(hashtable_t *ht, void *key)
+{
+    return ht_find_slot(ht, key, ht->hash_function(key)) != NULL;
+}
+
+void *ht_get(hashtable_t *ht, void *key)
+{
+    ht_slot_t *slot = ht_find_slot(ht, key, ht->hash_function(key));
+
+    if (slot == NULL)
+        return NULL;
+
+    return slot->entry.value;
+}
+
+/*
+ * Nr. de intrari cu acest hash. Toate stau in cele doua bucket-uri ale lui sau
+ * in stash, deci numaratoarea e O(1).
+ */
+static unsigned int ht_count_hash(hashtable_t *ht, unsigned int hash)
+{
+    ht_bucket_t *b1 = &ht->buckets[ht_bucket1(ht, hash)];
+    ht_bucket_t *b2 = &ht->buckets[ht_bucket2(ht, hash)];
+    unsigned int count = 0;
+
+    for (int i = 0; i < HT_BUCKET_SLOTS; ++i) {
+        count += b1->slots[i].entry.key != NULL && b1->slots[i].hash == hash;
+        count += b2->slots[i].entry.key != NULL && b2->slots[i].hash == hash;
+    }
+    for (unsigned int i = 0; i < ht->stash_size; ++i)
+        count += ht->stash[i].hash == hash;
+
+    return count;
+}
+
+/*
+ * La fel ca in varianta cu liste, cheia si valoarea se copiaza. Copiile sunt
+ * puse intr-un singur bloc: cheia la inceput, valoarea imediat dupa, aliniata
+ * la sizeof(void*). Intoarce 0 la succes si -1 daca o cheie noua nu are loc:
+ * prea multe chei cu acelasi hash sau tabela nu se poate reconstrui.
+ */
+int ht_put(hashtable_t *ht, void *key, unsigned int key_size,
+	void *value, unsigned int value_size)
+{
+    unsigned int hash = ht->hash_function(key);
+    ht_slot_t *found = ht_find_slot(ht, key, hash);
+
+    if (found != NULL) {
+        memcpy(found->entry.value, value, value_size);
+        return 0;
+    }
+
+    if (ht_count_hash(ht, hash) >= 2 * HT_BUCKET_SLOTS + HT_STASH_SIZE)
+        return -1;
+
+    if ((ht->size + 1) * HT_LOAD_DEN >
+        ht->nbuckets * HT_BUCKET_SLOTS * HT_LOAD_NUM)
+        ht_rebuild(ht, 2 * ht->nbuckets, NULL);
+
+    unsigned int value_off = (key_size + sizeof(void*) - 1) &
+                             ~(unsigned int)(sizeof(void*) - 1);
+    char *block = malloc(value_off + value_size);
+    memcpy(block, key, key_size);
+    memcpy(block + value_off, value, value_size);
+
+    ht_slot_t slot;
+    slot.hash = hash;
+    slot.entry.key = block;
+    slot.entry.value = block + value_off;
+
+    /* Stash plin: intrarea noua intra in reconstruire. */
+    if (!ht_insert_slot(ht, &slot) &&
+        !ht_rebuild(ht, 2 * ht->nbuckets, &slot)) {
+        free(block);
+        return -1;
+    }
+    ht->size++;
+    return 0;
+}
+
+/*
+ * Procedura care elimina din hashtable intrarea asociata cheii key. Locul
+ * eliberat poate primi inapoi intrari din stash.
+ */
+void ht_remove_entry(hashtable_t *ht, void *key)
+{
+    ht_slot_t *slot = ht_find_slot(ht, key, ht->hash_function(key));
+
+    if (slot == NULL)
+        return;
+
+    ht->key_val_free_function(&slot->entry);
+    ht->size--;
+
+    if (slot >= ht->stash && slot < ht->stash + HT_STASH_SIZE) {
+        *slot = ht->stash[--ht->stash_size];
+        return;
+    }
+
+    for (unsigned int i = 0; i < ht->stash_size; ) {
+        ht_slot_t *s = &ht->stash[i];
+        if (ht_place_in(ht, ht_bucket1(ht, s->hash), s) ||
+            ht_place_in(ht, ht_bucket2(ht, s->hash), s))
+            *s = ht->stash[--ht->stash_size];
+        else
+            i++;
+    }
+}
+
+/*
+ * Procedura care elibereaza memoria folosita de toate intrarile din hashtable,
+ * dupa care elibereaza si memoria folosita pentru a stoca structura hashtable.
+ */
+void ht_free(hashtable_t *ht)
+{
+    for (unsigned int b = 0; b < ht->nbuckets; ++b) {
+        for (int i = 0; i < HT_BUCKET_SLOTS; ++i) {
+            if (ht->buckets[b].slots[i].entry.key != NULL)
+                ht->key_val_free_function(&ht->buckets[b].slots[i].entry);
+        }
+    }
+    for (unsigned int i = 0; i < ht->stash_size; ++i)
+        ht->key_val_free_function(&ht->stash[i].entry);
+
+    free(ht->buckets);
+    free(ht);
+}
+
+unsigned int ht_get_size(hashtable_t *ht)
+{
+	if (ht == NULL)
+		return 0;
+
+	return ht->size;
+}
+
+unsigned int ht_get_hmax(hashtable_t *ht)
+{
+	if (ht == NULL)
+		return 0;
+
+	return ht->nbuckets * HT_BUCKET_SLOTS;
+}
+
+static double now_sec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int compare_doubles(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+
+    return (x > y) - (x < y);
+}
+
+/*
+ * Sorteaza latentele si afiseaza p50, p99, p99.9 si maximul, in ns.
+ */
+static void print_percentiles(const char *what, double *lat, unsigned int n)
+{
+    qsort(lat, n, sizeof(double), compare_doubles);
+    printf("%-4s p50: %7.0f ns | p99: %7.0f ns | p999: %7.0f ns | "
+           "max: %9.0f ns\n", what, lat[n / 2] * 1e9,
+           lat[(unsigned long)n * 99 / 100] * 1e9,
+           lat[(unsigned long)n * 999 / 1000] * 1e9, lat[n - 1] * 1e9);
+}
+
+/*
+ * Masoara separat fiecare ht_put si fiecare ht_get intr-o tabela cu n chei int
+ * (pornind de la HMAX) si afiseaza distributia latentelor. Aceeasi comanda
+ * exista in hash-table.c si in cuckoo.c, ca sa putem compara cozile.
+ */
+void bench_latency(unsigned int n)
+{
+    hashtable_t *ht = ht_create(HMAX, hash_function_int, compare_function_ints,
+                                key_val_free_function);
+    double *lat = malloc(n * sizeof(double));
+    long sink = 0;
+
+    for (unsigned int i = 0; i < n; ++i) {
+        double start = now_sec();
+        ht_put(ht, &i, sizeof(i), &i, sizeof(i));
+        lat[i] = now_sec() - start;
+    }
+    print_percentiles("put", lat, n);
+
+    srand(13);
+    for (unsigned int i = 0; i < n; ++i) {
+        unsigned int key = rand() % n;
+        double start = now_sec();
+        int *value = ht_get(ht, &key);
+        lat[i] = now_sec() - start;
+        sink += *value;
+    }
+    print_percentiles("get", lat, n);
+
+    ht_free(ht);
+    free(lat);
+    if (sink == 42)
+        printf("\n");
+}
+
+struct FriendInfo {
+	char name[MAX_STRING_SIZE];
+	char faculty[MAX_STRING_SIZE];
+	char fav_food[MAX_STRING_SIZE];
+	int age;
+};
+
+static void print_friend(struct FriendInfo *f_info)
+{
+	if (f_info == NULL) {
+		printf("Friend doesn't exist!\n");
+		return;
+	}
+	printf("Name: %s | ", f_info->name);
+	printf("Age: %d | ", f_info->age);
+	printf("Faculty: %s | ", f_info->faculty);
+	printf("Favorite food: %s\n", f_info->fav_food);
+}
+
+int main()
+{
+	hashtable_t *ht_friends = NULL;
+	struct FriendInfo info_f;
+	struct FriendInfo *p_infoFriend;
+
+	while (1) {
+		char command[MAX_STRING_SIZE];
+
+		if (scanf("%s", command) != 1)
+			break;
+		if (strncmp(command, "create_ht", 9) == 0) {
+			ht_friends = ht_create(HMAX, hash_function_string,
+				compare_function_strings, key_val_free_function);
+
+		} else if (strncmp(command, "add_friend", 10) == 0) {
+			scanf("%s %d %s %s", info_f.name, &info_f.age,
+				info_f.faculty, info_f.fav_food);
+
+			if (!ht_friends) {
+				printf("Create hashtable first.\n");
+			} else {
+				if (ht_put(ht_friends, info_f.name, strlen(info_f.name) + 1,
+					&info_f, sizeof(info_f)) != 0)
+					printf("Could not add friend %s.\n", info_f.name);
+			}
+
+		} else if (strncmp(command, "print_friend", 12) == 0) {
+			char name[MAX_STRING_SIZE];
+
+			scanf("%s", name);
+
+			if (!ht_friends) {
+				printf("Create hashtable first.\n");
+			} else {
+				p_infoFriend = ht_get(ht_friends, name);
+				print_friend(p_infoFriend);
+			}
+
+		} else if (strncmp(command, "check_friend", 12) == 0) {
+			char name[MAX_STRING_SIZE];
+
+			scanf("%s", name);
+			if (!ht_friends) {
+				printf("Create hashtable first.\n");
+			} else if(ht_has_key(ht_friends, name)) {
+				printf("Friend %s exists.\n", name);
+			} else {
+				printf("Friend %s doesn't exist.\n", name);
+			}
+
+		} else if (strncmp(command, "remove_friend", 13) == 0) {
+			char name[MAX_STRING_SIZE];
+
+			scanf("%s", name);
+			if (!ht_friends) {
+				printf("Create hashtable first.\n");
+			} else {
+				ht_remove_entry(ht_friends, name);
+			}
+
+		} else if (strncmp(command, "cuckoo_stats", 12) == 0) {
+			if (!ht_friends) {
+				printf("Create hashtable first.\n");
+			} else {
+				printf("Size: %u | Slots: %u | Stash: %u | Kicks: %lu | "
+				       "Rebuilds: %lu\n", ht_friends->size,
+				       ht_get_hmax(ht_friends), ht_friends->stash_size,
+				       ht_friends->kicks, ht_friends->rebuilds);
+			}
+
+		} else if (strncmp(command, "bench_latency", 13) == 0) {
+			unsigned int n;
+
+			scanf("%u", &n);
+			bench_latency(n);
+
+		} else if (strncmp(command, "free", 4) == 0) {
+			if (!ht_friends) {
+				printf("Create hashtable first.\n");
+			} else {
+				ht_free(ht_friends);
+			}
+			break;
+		}
+	}
+
+	return 0;
+}
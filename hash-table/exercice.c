@@ -366,17 +366,24 @@ int ht_has_key(hashtable_t *ht, void *key)
 	return 0;
 }
 
-void ht_get(hashtable_t *ht, void *key) {
-  unsigned int index = ht->hash_function(key) % ht->hmax;
-  ll_node_t *node = ht->buckets[index]->head;
-
-  while (node != NULL) {
-    if (ht->compare_function(((info *)node->data)->key, key) == 0) {
-      struct PatientInfo *info_p = ((info *)node->data)->value;
-      print_patient(info_p);
-    }
-    node = node->next;
-  }
+/*
+ * Functie care intoarce valoarea asociata cheii key.
+ * Atentie! Daca pentru cheia key nu a fost asociata anterior o valoare,
+ * functia intoarce NULL.
+ */
+void *ht_get(hashtable_t *ht, void *key)
+{
+	unsigned int index = ht->hash_function(key) % ht->hmax;
+	ll_node_t *node = ht->buckets[index]->head;
+
+	while (node != NULL) {
+		info *information = node->data;
+		if (ht->compare_function(information->key, key) == 0)
+			return information->value;
+		node = node->next;
+	}
+
+	return NULL;
 }
 
 /*
@@ -400,7 +407,20 @@ void ht_put(hashtable_t *ht, void *key, unsigned int key_size,
 	void *value, unsigned int value_size)
 {
 	__uint32_t index = ht->hash_function(key) % ht->hmax;
-    
+    ll_node_t *node = ht->buckets[index]->head;
+
+    /* Cheia exista deja: doar se inlocuieste valoarea. */
+    while (node != NULL) {
+        info *found = node->data;
+        if (ht->compare_function(found->key, key) == 0) {
+            free(found->value);
+            found->value = malloc(value_size);
+            memcpy(found->value, value, value_size);
+            return;
+        }
+        node = node->next;
+    }
+
     ht->size++;
 
     info *information = malloc(sizeof(info));
@@ -438,7 +458,6 @@ void ht_remove_entry(hashtable_t *ht, void *key)
             info *information = remove->data;
             free(information->key);
             free(information->value);
-            free(information);
             free(remove->data);
             free(remove);
             ht->size--;
@@ -490,18 +509,211 @@ unsigned int ht_get_hmax(hashtable_t *ht)
 	return ht->hmax;
 }
 
+/*
+ * Multi-index peste un set de inregistrari PatientInfo.
+ *
+ * Inregistrarile se tin o singura data, intr-un vector; fiecare index are un
+ * vector order[] cu id-urile (pozitiile) inregistrarilor grupate dupa cheia
+ * indexului si un hashtable cheie -> mi_range_t. O cautare face un singur
+ * ht_get si intoarce intervalul contiguu order[start .. start + count), fara
+ * sa mai parcurga lanturi si sa compare fiecare inregistrare.
+ *
+ * Indecsii se reconstruiesc (counting sort dupa cheie, O(n)) la prima cautare
+ * de dupa o serie de adaugari; in interiorul unui grup, inregistrarile raman
+ * in ordinea in care au fost adaugate.
+ */
+enum { MI_BY_NAME, MI_BY_CITY, MI_BY_AGE, MI_NINDEXES };
+
+typedef struct mi_range_t mi_range_t;
+struct mi_range_t {
+	unsigned int start;
+	unsigned int count;
+};
+
+typedef struct mi_index_t mi_index_t;
+struct mi_index_t {
+	hashtable_t *groups; /* Cheie -> mi_range_t. */
+	unsigned int *order; /* Id-urile inregistrarilor, grupate pe cheie. */
+	/* (Pointer la) Functie care intoarce cheia indexului pentru o inregistrare. */
+	void *(*key_of)(struct PatientInfo *);
+	unsigned int (*key_size)(void *);
+	unsigned int (*hash_function)(void *);
+	int (*compare_function)(void *, void *);
+};
+
+typedef struct multi_index_t multi_index_t;
+struct multi_index_t {
+	struct PatientInfo *records;
+	unsigned int count;
+	unsigned int cap;
+	int dirty; /* Au fost adaugate inregistrari de la ultima reconstruire. */
+	mi_index_t idx[MI_NINDEXES];
+};
+
+static void *patient_name(struct PatientInfo *p)
+{
+	return p->name;
+}
+
+static void *patient_city(struct PatientInfo *p)
+{
+	return p->city;
+}
+
+static void *patient_age(struct PatientInfo *p)
+{
+	return &p->age;
+}
+
+static unsigned int key_size_string(void *key)
+{
+	return strlen(key) + 1;
+}
+
+static unsigned int key_size_int(void *key)
+{
+	(void)key;
+	return sizeof(int);
+}
+
+multi_index_t *mi_create(void)
+{
+	multi_index_t *mi = calloc(1, sizeof(multi_index_t));
+
+	mi->idx[MI_BY_NAME] = (mi_index_t){NULL, NULL, patient_name,
+		key_size_string, hash_function_string, compare_function_strings};
+	mi->idx[MI_BY_CITY] = (mi_index_t){NULL, NULL, patient_city,
+		key_size_string, hash_function_string, compare_function_strings};
+	mi->idx[MI_BY_AGE] = (mi_index_t){NULL, NULL, patient_age,
+		key_size_int, hash_function_int, compare_function_ints};
+
+	return mi;
+}
+
+void mi_add(multi_index_t *mi, struct PatientInfo *patient)
+{
+	if (mi->count == mi->cap) {
+		mi->cap = mi->cap ? 2 * mi->cap : HMAX;
+		mi->records = realloc(mi->records,
+				      mi->cap * sizeof(struct PatientInfo));
+	}
+
+	mi->records[mi->count++] = *patient;
+	mi->dirty = 1;
+}
+
+static void mi_free_index(mi_index_t *index)
+{
+	if (index->groups)
+		ht_free(index->groups);
+	free(index->order);
+	index->groups = NULL;
+	index->order = NULL;
+}
+
+/*
+ * Reconstruieste un index: numara inregistrarile pentru fiecare cheie,
+ * atribuie fiecarui grup un start (sume partiale) si apoi aseaza id-urile.
+ */
+static void mi_build_index(multi_index_t *mi, mi_index_t *index)
+{
+	mi_free_index(index);
+	index->groups = ht_create(mi->count > HMAX ? mi->count : HMAX,
+				  index->hash_function, index->compare_function,
+				  key_val_free_function);
+	index->order = malloc((mi->count ? mi->count : 1) * sizeof(unsigned int));
+
+	for (unsigned int i = 0; i < mi->count; ++i) {
+		void *key = index->key_of(&mi->records[i]);
+		mi_range_t *range = ht_get(index->groups, key);
+
+		if (range != NULL) {
+			range->count++;
+		} else {
+			mi_range_t first = {0, 1};
+			ht_put(index->groups, key, index->key_size(key), &first,
+			       sizeof(first));
+		}
+	}
+
+	unsigned int start = 0;
+	for (unsigned int i = 0; i < index->groups->hmax; ++i) {
+		ll_node_t *node = index->groups->buckets[i]->head;
+		for (; node != NULL; node = node->next) {
+			mi_range_t *range = ((info *)node->data)->value;
+			range->start = start;
+			start += range->count;
+			/* Refolosit ca pozitie de scriere in pasul urmator. */
+			range->count = 0;
+		}
+	}
+
+	for (unsigned int i = 0; i < mi->count; ++i) {
+		mi_range_t *range = ht_get(index->groups,
+					   index->key_of(&mi->records[i]));
+		index->order[range->start + range->count++] = i;
+	}
+}
+
+/*
+ * Intoarce inregistrarile care au cheia key in indexul which: un pointer la
+ * primul id din interval (NULL daca nu exista niciuna), iar in *count nr. lor.
+ */
+const unsigned int *mi_find(multi_index_t *mi, int which, void *key,
+			    unsigned int *count)
+{
+	if (mi->dirty) {
+		for (int i = 0; i < MI_NINDEXES; ++i)
+			mi_build_index(mi, &mi->idx[i]);
+		mi->dirty = 0;
+	}
+
+	mi_index_t *index = &mi->idx[which];
+	mi_range_t *range = index->groups ? ht_get(index->groups, key) : NULL;
+
+	if (range == NULL) {
+		*count = 0;
+		return NULL;
+	}
+
+	*count = range->count;
+	return index->order + range->start;
+}
+
+void mi_free(multi_index_t *mi)
+{
+	for (int i = 0; i < MI_NINDEXES; ++i)
+		mi_free_index(&mi->idx[i]);
+	free(mi->records);
+	free(mi);
+}
+
+static void print_patients(multi_index_t *mi, int which, void *key,
+			   const char *what)
+{
+	unsigned int count;
+	const unsigned int *ids = mi_find(mi, which, key, &count);
+
+	if (ids == NULL) {
+		printf("Patients %s not found\n", what);
+		return;
+	}
+
+	for (unsigned int i = 0; i < count; ++i)
+		print_patient(&mi->records[ids[i]]);
+}
+
 int main() {
-  hashtable_t *ht_patients = NULL;
+  multi_index_t *patients = NULL;
   struct PatientInfo info_f;
 
   while (1) {
     char command[MAX_STRING_SIZE];
 
-    scanf("%s", command);
+    if (scanf("%s", command) != 1)
+      break;
     if (strncmp(command, "create_ht", 9) == 0) {
-      ht_patients = ht_create(HMAX, hash_function_string,
-                              compare_function_strings, key_val_free_function);
-      /* E de ajuns un singur hashtable? */
+      patients = mi_create();
 
     } else if (strncmp(command, "add_patients", 12) == 0) {
       int nr;
@@ -509,29 +721,40 @@ int main() {
       for (int i = 0; i < nr; i++) {
         scanf("%s %s %d %s", info_f.name, info_f.city, &info_f.age,
               info_f.health);
-        ht_put(ht_patients, info_f.city, strlen(info_f.city) + 1, &info_f,
-               sizeof(info_f));
+        mi_add(patients, &info_f);
       }
 
     } else if (strncmp(command, "print_patients_from", 19) == 0) {
-      char oras[MAX_STRING_SIZE];
+      char oras[MAX_STRING_SIZE], what[MAX_STRING_SIZE + 8];
       scanf("%s", oras);
 
-      if (ht_has_key(ht_patients, oras)) {
-        ht_get(ht_patients, oras);
-      } else {
-        printf("Patients from %s not found\n", oras);
-      }
+      snprintf(what, sizeof(what), "from %s", oras);
+      print_patients(patients, MI_BY_CITY, oras, what);
+
+    } else if (strncmp(command, "print_patients_named", 20) == 0) {
+      char nume[MAX_STRING_SIZE], what[MAX_STRING_SIZE + 8];
+      scanf("%s", nume);
+
+      snprintf(what, sizeof(what), "named %s", nume);
+      print_patients(patients, MI_BY_NAME, nume, what);
+
+    } else if (strncmp(command, "print_patients_aged", 19) == 0) {
+      int varsta;
+      char what[32];
+      scanf("%d", &varsta);
+
+      snprintf(what, sizeof(what), "aged %d", varsta);
+      print_patients(patients, MI_BY_AGE, &varsta, what);
 
     } else if (strncmp(command, "free", 4) == 0) {
-      if (!ht_patients) {
+      if (!patients) {
         printf("Create hashtable first.\n");
       } else {
-        ht_free(ht_patients);
+        mi_free(patients);
       }
       break;
     }
   }
 
   return 0;
-}
\ No newline at end of file
+}
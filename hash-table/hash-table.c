@@ -1,6 +1,14 @@
+#define _GNU_SOURCE /* qsort_r */
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <malloc.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #define MAX_STRING_SIZE	256
 #define HMAX 10
@@ -203,6 +211,89 @@ typedef struct info info;
 struct info {
 	void *key;
 	void *value;
+	/*
+	 * Hash-ul complet al cheii. Se compara inaintea lui compare_function si se
+	 * refoloseste la redimensionare, deci cheile nu se mai hash-uiesc din nou.
+	 */
+	unsigned int hash;
+	/* HT_KEY_INLINE / HT_VALUE_INLINE: copia sta imediat dupa structura. */
+	unsigned char flags;
+	/* Marimile copiilor, necesare cand intrarea e scrisa intr-un snapshot. */
+	unsigned int key_size;
+	unsigned int value_size;
+	/* Lista de recenta, folosita doar in modul cache (ht_set_capacity). */
+	info *lru_prev;
+	info *lru_next;
+};
+
+#define HT_KEY_INLINE	1
+#define HT_VALUE_INLINE	2
+/*
+ * Cheile si valorile de cel mult atatia octeti sunt copiate in acelasi bloc cu
+ * structura info, fara malloc separat. Pragul se schimba cu ht_set_inline_max.
+ */
+#define HT_INLINE_MAX	16
+
+/*
+ * Bucata de memorie dintr-un arena: alocarile se fac prin simpla avansare a
+ * lui used, iar bucatile se elibereaza toate odata, in ht_free.
+ */
+typedef struct ht_arena_chunk_t ht_arena_chunk_t;
+struct ht_arena_chunk_t {
+	ht_arena_chunk_t *next;
+	size_t used;
+	size_t cap;
+	char data[];
+};
+
+#define HT_ARENA_CHUNK	(64 * 1024)
+
+/*
+ * Histograma nr. de noduri vizitate la o cautare (si a lungimilor lanturilor,
+ * in ht_print_stats). Intervalele sunt: 0, 1, 2, 3, 4, 5-8, 9-16, 17+.
+ */
+#define HT_HIST_SIZE	8
+
+/*
+ * Contoare actualizate la fiecare operatie. Sunt doar incrementari de
+ * intregi, deci pot ramane compilate si in productie. Timpul se masoara doar
+ * in pasii de redimensionare.
+ */
+typedef struct ht_stats_t ht_stats_t;
+struct ht_stats_t {
+	unsigned long lookups; /* get, has_key, find_or_insert, remove */
+	unsigned long probe_hist[HT_HIST_SIZE];
+	unsigned long compares; /* Apeluri ale comparatorului (sau memcmp). */
+	unsigned long resizes;
+	unsigned long bloom_rejects; /* Cautari oprite de filtrul Bloom. */
+	/* Doar in modul cache: rezultatele lui ht_get si intrarile evacuate. */
+	unsigned long hits;
+	unsigned long misses;
+	unsigned long evictions;
+	double rehash_sec; /* Timpul total petrecut in ht_rehash_step. */
+	double rehash_max_step_sec;
+	double resize_start; /* Momentul inceperii redimensionarii curente. */
+	double last_resize_sec; /* Cat a durat ultima redimensionare completa. */
+};
+
+/*
+ * Filtru Bloom blocat, cu numaratori (permite si stergeri). Fiecare bloc are
+ * HT_BLOOM_BLOCK numaratori de 8 biti, adica exact o linie de cache; o cheie
+ * incrementeaza HT_BLOOM_K numaratori din acelasi bloc, alesi din hash-ul deja
+ * pastrat in info. Un numarator ajuns la 255 ramane blocat acolo (nu se mai
+ * decrementeaza), deci filtrul nu poate da niciodata un fals negativ.
+ */
+#define HT_BLOOM_BLOCK	64
+#define HT_BLOOM_K	4
+/* Numaratori per cheie; ~12 dau sub 1% fals pozitive. */
+#define HT_BLOOM_PER_KEY	12
+
+typedef struct ht_bloom_t ht_bloom_t;
+struct ht_bloom_t {
+	unsigned char *counters; /* nblocks * HT_BLOOM_BLOCK, aliniat la 64. */
+	unsigned int nblocks;
+	/* Nr. de chei pentru care a fost dimensionat; peste el se reconstruieste. */
+	unsigned int capacity;
 };
 
 typedef struct hashtable_t hashtable_t;
@@ -211,12 +302,66 @@ struct hashtable_t {
 	/* Nr. total de noduri existente curent in toate bucket-urile. */
 	unsigned int size;
 	unsigned int hmax; /* Nr. de bucket-uri. */
+	unsigned int min_hmax; /* Sub acest nr. de bucket-uri nu micsoram tabela. */
+	/*
+	 * Cat timp old_buckets != NULL tabela e in curs de redimensionare:
+	 * bucket-urile vechi cu index < rehash_idx au fost deja mutate in buckets,
+	 * restul sunt inca in old_buckets.
+	 */
+	linked_list_t **old_buckets;
+	unsigned int old_hmax;
+	unsigned int rehash_idx;
+	/* Nr. de apeluri ht_find_or_insert si nr. total de noduri comparate. */
+	unsigned long upsert_calls;
+	unsigned long upsert_probes;
+	/*
+	 * Cate noduri ar fi vizitat aceleasi put-uri pe drumul vechi: ht_has_key
+	 * (pana la cheie, sau tot lantul daca lipseste), plus, daca cheia exista,
+	 * a doua parcurgere a intregului lant ca sa se suprascrie valoarea.
+	 */
+	unsigned long upsert_legacy_probes;
 	/* (Pointer la) Functie pentru a calcula valoarea hash asociata cheilor. */
 	unsigned int (*hash_function)(void*);
 	/* (Pointer la) Functie pentru a compara doua chei. */
 	int (*compare_function)(void*, void*);
 	/* (Pointer la) Functie pentru a elibera memoria ocupata de cheie si valoare. */
 	void (*key_val_free_function)(void*);
+	/*
+	 * Daca e setata, se foloseste in locul lui hash_function. Primeste si
+	 * lungimea cheii: key_len octeti, sau strlen(key) daca key_len == 0.
+	 */
+	uint64_t (*hash_function_len)(const void*, size_t, uint64_t);
+	uint64_t seed;
+	unsigned int key_len;
+	unsigned int inline_max; /* Vezi HT_INLINE_MAX. */
+	/*
+	 * Daca use_arena != 0, nodurile, structurile info, copiile cheilor si
+	 * valorilor si listele bucket-urilor se aloca din arena (vezi
+	 * ht_enable_arena).
+	 */
+	int use_arena;
+	ht_arena_chunk_t *arena;
+	/* Nr. de iteratori activi; cat timp e > 0 redimensionarea e suspendata. */
+	unsigned int iterators;
+	/*
+	 * Nodurile sterse cat timp exista iteratori activi. Sunt scoase din
+	 * bucket-uri, dar raman alocate (cu data == NULL) pana la ultimul
+	 * ht_iter_release, ca un iterator care le-a retinut sa poata merge mai
+	 * departe pe next.
+	 */
+	ll_node_t **dead_nodes;
+	unsigned int dead_count;
+	unsigned int dead_cap;
+	ht_stats_t stats;
+	ht_bloom_t *bloom; /* NULL daca filtrul nu e activat (ht_enable_bloom). */
+	/*
+	 * Modul cache: daca capacity != 0, tabela are cel mult capacity intrari.
+	 * lru_head e intrarea folosita cel mai recent, lru_tail cea evacuata la
+	 * urmatoarea inserare peste capacitate.
+	 */
+	unsigned int capacity;
+	info *lru_head;
+	info *lru_tail;
 };
 
 /*
@@ -275,6 +420,196 @@ unsigned int hash_function_string(void *a)
 	return hash;
 }
 
+
+/*
+ * Functii de hashing care primesc si lungimea cheii, plus un seed. Spre
+ * deosebire de cele de mai sus, merg si pe chei binare (UUID-uri, id-uri pe 64
+ * de biti etc.). Se folosesc prin ht_create_seeded.
+ */
+static inline uint64_t read64(const unsigned char *p)
+{
+	uint64_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static inline uint64_t read32(const unsigned char *p)
+{
+	uint32_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+/* djb2, ca hash_function_string, dar pe len octeti: baza de comparatie. */
+uint64_t hash_len_djb2(const void *key, size_t len, uint64_t seed)
+{
+	const unsigned char *p = key;
+	uint64_t hash = 5381 ^ seed;
+
+	while (len--)
+		hash = ((hash << 5u) + hash) + *p++;
+
+	return hash;
+}
+
+/*
+ * Credits: https://github.com/wangyi-fudan/wyhash (varianta simplificata, fara
+ * protectiile pentru platforme fara __uint128_t).
+ */
+static inline uint64_t wymix(uint64_t a, uint64_t b)
+{
+	__uint128_t r = (__uint128_t)a * b;
+	return (uint64_t)r ^ (uint64_t)(r >> 64);
+}
+
+uint64_t hash_len_wyhash(const void *key, size_t len, uint64_t seed)
+{
+	static const uint64_t s[4] = {0xa0761d6478bd642full, 0xe7037ed1a0b428dbull,
+		0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull};
+	const unsigned char *p = key;
+	uint64_t a, b;
+
+	seed ^= wymix(seed ^ s[0], s[1]);
+	if (len <= 16) {
+		if (len >= 4) {
+			a = (read32(p) << 32) | read32(p + ((len >> 3) << 2));
+			b = (read32(p + len - 4) << 32) |
+				read32(p + len - 4 - ((len >> 3) << 2));
+		} else if (len > 0) {
+			a = ((uint64_t)p[0] << 16) | ((uint64_t)p[len >> 1] << 8) |
+				p[len - 1];
+			b = 0;
+		} else {
+			a = b = 0;
+		}
+	} else {
+		size_t i = len;
+		if (i > 48) {
+			uint64_t see1 = seed, see2 = seed;
+			do {
+				seed = wymix(read64(p) ^ s[1], read64(p + 8) ^ seed);
+				see1 = wymix(read64(p + 16) ^ s[2], read64(p + 24) ^ see1);
+				see2 = wymix(read64(p + 32) ^ s[3], read64(p + 40) ^ see2);
+				p += 48;
+				i -= 48;
+			} while (i > 48);
+			seed ^= see1 ^ see2;
+		}
+		while (i > 16) {
+			seed = wymix(read64(p) ^ s[1], read64(p + 8) ^ seed);
+			i -= 16;
+			p += 16;
+		}
+		a = read64(p + i - 16);
+		b = read64(p + i - 8);
+	}
+
+	__uint128_t r = (__uint128_t)(a ^ s[1]) * (b ^ seed);
+	return wymix((uint64_t)r ^ s[0] ^ len, (uint64_t)(r >> 64) ^ s[1]);
+}
+
+/*
+ * Credits: https://github.com/Cyan4973/xxHash (XXH64).
+ */
+#define XXH_P1 11400714785074694791ull
+#define XXH_P2 14029467366897019727ull
+#define XXH_P3 1609587929392839161ull
+#define XXH_P4 9650029242287828579ull
+#define XXH_P5 2870177450012600261ull
+
+static inline uint64_t rotl64(uint64_t x, int r)
+{
+	return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t xxh_round(uint64_t acc, uint64_t input)
+{
+	acc += input * XXH_P2;
+	acc = rotl64(acc, 31);
+	return acc * XXH_P1;
+}
+
+static inline uint64_t xxh_merge(uint64_t acc, uint64_t val)
+{
+	acc ^= xxh_round(0, val);
+	return acc * XXH_P1 + XXH_P4;
+}
+
+uint64_t hash_len_xxh64(const void *key, size_t len, uint64_t seed)
+{
+	const unsigned char *p = key;
+	const unsigned char *end = p + len;
+	uint64_t h;
+
+	if (len >= 32) {
+		uint64_t v1 = seed + XXH_P1 + XXH_P2;
+		uint64_t v2 = seed + XXH_P2;
+		uint64_t v3 = seed;
+		uint64_t v4 = seed - XXH_P1;
+
+		/* Patru acumulatori independenti: CPU-ul ii poate calcula in paralel. */
+		do {
+			v1 = xxh_round(v1, read64(p));
+			v2 = xxh_round(v2, read64(p + 8));
+			v3 = xxh_round(v3, read64(p + 16));
+			v4 = xxh_round(v4, read64(p + 24));
+			p += 32;
+		} while (p + 32 <= end);
+
+		h = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+		h = xxh_merge(h, v1);
+		h = xxh_merge(h, v2);
+		h = xxh_merge(h, v3);
+		h = xxh_merge(h, v4);
+	} else {
+		h = seed + XXH_P5;
+	}
+
+	h += len;
+	while (p + 8 <= end) {
+		h ^= xxh_round(0, read64(p));
+		h = rotl64(h, 27) * XXH_P1 + XXH_P4;
+		p += 8;
+	}
+	if (p + 4 <= end) {
+		h ^= read32(p) * XXH_P1;
+		h = rotl64(h, 23) * XXH_P2 + XXH_P3;
+		p += 4;
+	}
+	while (p < end) {
+		h ^= *p++ * XXH_P5;
+		h = rotl64(h, 11) * XXH_P1;
+	}
+
+	h ^= h >> 33;
+	h *= XXH_P2;
+	h ^= h >> 29;
+	h *= XXH_P3;
+	h ^= h >> 32;
+	return h;
+}
+
+/*
+ * Pentru chei de exact 8 octeti (id-uri): un singur pas de amestecare
+ * (finalizatorul din MurmurHash3), fara bucle. Cheile de alta lungime (sau
+ * string-urile, pentru key_len == 0) se hash-uiesc cu wyhash, ca sa nu se
+ * citeasca dincolo de cheie.
+ */
+uint64_t hash_len_u64(const void *key, size_t len, uint64_t seed)
+{
+	if (len != 8)
+		return hash_len_wyhash(key, len, seed);
+
+	uint64_t x = read64(key) ^ seed;
+
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdull;
+	x ^= x >> 33;
+	x *= 0xc4ceb9fe1a85ec53ull;
+	x ^= x >> 33;
+	return x;
+}
+
 /*
  * Functie apelata pentru a elibera memoria ocupata de cheia si valoarea unei
  * perechi din hashtable. Daca cheia sau valoarea contin tipuri de date complexe
@@ -286,226 +621,2218 @@ void key_val_free_function(void *data) {
         return;
     info *information = (info*) data;
     
-    if (information->key)
+    /* Copiile mici sunt in acelasi bloc cu info si dispar odata cu el. */
+    if (information->key && !(information->flags & HT_KEY_INLINE))
         free(information->key);
-    if(information->value)
+    if(information->value && !(information->flags & HT_VALUE_INLINE))
         free(information->value);
     
     free(information);
 }//check
 
+static double now_sec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static unsigned int ht_hist_index(unsigned long value)
+{
+    if (value <= 4)
+        return value;
+    if (value <= 8)
+        return 5;
+    if (value <= 16)
+        return 6;
+    return 7;
+}
+
+static inline void ht_record_probes(hashtable_t *ht, unsigned int probes)
+{
+    ht->stats.lookups++;
+    ht->stats.probe_hist[ht_hist_index(probes)]++;
+}
+
+/*
+ * Pragurile factorului de incarcare (size / hmax). Tabela se dubleaza cand are
+ * in medie mai mult de HT_GROW_LOAD noduri pe bucket si se injumatateste cand
+ * are sub 1 / HT_SHRINK_DIV noduri pe bucket (dar nu sub hmax-ul initial).
+ */
+#define HT_GROW_LOAD 1
+#define HT_SHRINK_DIV 8
+/*
+ * Numarul maxim de bucket-uri vechi mutate la un singur put/remove. Astfel o
+ * redimensionare nu blocheaza niciodata un apel, ci e impartita pe mai multe.
+ */
+#define HT_REHASH_STEP 4
+
 /*
  * Functie apelata dupa alocarea unui hashtable pentru a-l initializa.
- * Trebuie alocate si initializate si listele inlantuite.
+ * Listele inlantuite se aloca abia la prima inserare in bucket-ul respectiv,
+ * ca redimensionarea sa nu trebuiasca sa creeze hmax liste deodata.
  */
 hashtable_t *ht_create(unsigned int hmax, unsigned int (*hash_function)(void*),
 		int (*compare_function)(void*, void*),
 		void (*key_val_free_function)(void*))
 {
 	hashtable_t *table = malloc(sizeof(hashtable_t));
-    table->buckets = malloc(sizeof(linked_list_t*) * hmax);
+    table->buckets = calloc(hmax, sizeof(linked_list_t*));
     table->hmax = hmax;
+    table->min_hmax = hmax;
     table->size = 0;
 
-    for (int i = 0; i< hmax; ++i) {
-        table->buckets[i] = ll_create(sizeof(info));
-    }
+    table->old_buckets = NULL;
+    table->old_hmax = 0;
+    table->rehash_idx = 0;
 
+    table->upsert_calls = 0;
+    table->upsert_probes = 0;
+    table->upsert_legacy_probes = 0;
 
-    // Should i use the line below??
-   // memset(table->buckets, 0, hmax * sizeof(linked_list_t*));
-    
     table->key_val_free_function = key_val_free_function;
     table->hash_function = hash_function;
     table->compare_function = compare_function;
+
+    table->hash_function_len = NULL;
+    table->seed = 0;
+    table->key_len = 0;
+    table->inline_max = HT_INLINE_MAX;
+
+    table->use_arena = 0;
+    table->arena = NULL;
+    table->iterators = 0;
+    table->dead_nodes = NULL;
+    table->dead_count = 0;
+    table->dead_cap = 0;
+    memset(&table->stats, 0, sizeof(table->stats));
+    table->bloom = NULL;
+    table->capacity = 0;
+    table->lru_head = NULL;
+    table->lru_tail = NULL;
     
     return table;
 }//check
 
 /*
- * Functie care intoarce:
- * 1, daca pentru cheia key a fost asociata anterior o valoare in hashtable
- * folosind functia put;
- * 0, altfel.
+ * La fel ca ht_create, dar cheile se hash-uiesc cu hash_function_len(key, len,
+ * seed). Daca key_len != 0 toate cheile au key_len octeti, altfel sunt
+ * string-uri. Daca compare_function e NULL, cheile se compara cu memcmp pe
+ * key_len octeti, respectiv cu strcmp daca key_len == 0.
  */
-int ht_has_key(hashtable_t *ht, void *key)
+hashtable_t *ht_create_seeded(unsigned int hmax,
+		uint64_t (*hash_function_len)(const void*, size_t, uint64_t),
+		uint64_t seed, unsigned int key_len,
+		int (*compare_function)(void*, void*),
+		void (*key_val_free_function)(void*))
 {
-	__uint32_t index = ht->hash_function(key) % ht->hmax;
-    linked_list_t *entry_in = ht->buckets[index];
+    hashtable_t *table = ht_create(hmax, NULL, compare_function,
+                                   key_val_free_function);
 
-    if(entry_in == NULL)
-        return 0;
-    
-    ll_node_t *node = entry_in->head;
-    
-    while(node != NULL) {
-        info *information = node->data;
-        
-        if(ht->compare_function(key, information->key) == 0) 
-            return 1;
-        
-        node = node->next;
+    table->hash_function_len = hash_function_len;
+    table->seed = seed;
+    table->key_len = key_len;
+
+    return table;
+}
+
+/*
+ * Hash-ul pe 32 de biti pastrat in info si folosit pentru alegerea bucket-ului.
+ */
+static inline unsigned int ht_hash(hashtable_t *ht, void *key)
+{
+    if (ht->hash_function_len != NULL) {
+        size_t len = ht->key_len ? ht->key_len : strlen(key);
+        uint64_t hash = ht->hash_function_len(key, len, ht->seed);
+        return (unsigned int)(hash ^ (hash >> 32));
     }
 
-	return 0;
-}//check
+    return ht->hash_function(key);
+}
 
-void *ht_get(hashtable_t *ht, void *key)
+/*
+ * Compara doua chei cu compare_function sau, daca e NULL, cu memcmp pe key_len
+ * octeti, respectiv cu strcmp daca key_len == 0.
+ */
+static inline int ht_keys_compare(hashtable_t *ht, const void *a, const void *b)
 {
-    
-    __uint32_t index = ht->hash_function(key) % ht->hmax;
-    linked_list_t *entry = ht->buckets[index];
+    if (ht->compare_function == NULL)
+        return ht->key_len ? memcmp(a, b, ht->key_len) : strcmp(a, b);
 
-    if(entry == NULL)
-        return NULL;
-    
-    ll_node_t *node = entry->head;
+    return ht->compare_function((void *)a, (void *)b);
+}
 
-    while(node != NULL) {
-        info *information = node->data;
-        if(ht->compare_function(key,information->key) == 0) {
-            return information->value;
-        }
-        node = node->next;
+static inline int ht_keys_equal(hashtable_t *ht, void *a, void *b)
+{
+    ht->stats.compares++;
+    return ht_keys_compare(ht, a, b) == 0;
+}
+
+/*
+ * Aloca size octeti (aliniat la 8) din bucata curenta a arenei, adaugand o
+ * bucata noua de HT_ARENA_CHUNK octeti (sau mai mare) cand nu mai e loc.
+ */
+static void *ht_arena_alloc(ht_arena_chunk_t **arena, size_t size)
+{
+    size = (size + 7) & ~(size_t)7;
+    ht_arena_chunk_t *chunk = *arena;
+    if (chunk == NULL || chunk->used + size > chunk->cap) {
+        size_t cap = size > HT_ARENA_CHUNK ? size : HT_ARENA_CHUNK;
+        chunk = malloc(sizeof(ht_arena_chunk_t) + cap);
+        chunk->next = *arena;
+        chunk->used = 0;
+        chunk->cap = cap;
+        *arena = chunk;
     }
 
- 	return NULL;
+    void *ptr = chunk->data + chunk->used;
+    chunk->used += size;
+    return ptr;
 }
 
 /*
- * Atentie! Desi cheia este trimisa ca un void pointer (deoarece nu se impune
- * tipul ei), in momentul in care se creeaza o noua intrare in hashtable (in
- * cazul in care cheia nu se gaseste deja in ht), trebuie creata o copie a
- * valorii la care pointeaza key si adresa acestei copii trebuie salvata in
- * structura info asociata intrarii din ht. Pentru a sti cati octeti trebuie
- * alocati si copiati, folositi parametrul key_size.
- *
- * Motivatie:
- * Este nevoie sa copiem valoarea la care pointeaza key deoarece dupa un apel
- * put(ht, key_actual, value_actual), valoarea la care pointeaza key_actual
- * poate fi alterata (de ex: *key_actual++). Daca am folosi direct adresa
- * pointerului key_actual, practic s-ar modifica din afara hashtable-ului cheia
- * unei intrari din hashtable. Nu ne dorim acest lucru, fiindca exista riscul sa
- * ajungem in situatia in care nu mai stim la ce cheie este inregistrata o
- * anumita valoare.
+ * Aloca memorie pentru o intrare: cu malloc sau, in modul arena, din arena.
  */
-void ht_put(hashtable_t *ht, void *key, unsigned int key_size,
-	void *value, unsigned int value_size)
+static void *ht_mem_alloc(hashtable_t *ht, size_t size)
 {
-	__uint32_t index = ht->hash_function(key) % ht->hmax;
-    if (ht_has_key(ht, key) == 0) {
-        ht->size++;
+    if (!ht->use_arena)
+        return malloc(size);
 
-        info *information = malloc(sizeof(info));
-        information->key = malloc(key_size);
-        information->value = malloc(value_size);
+    return ht_arena_alloc(&ht->arena, size);
+}
 
-        memcpy(information->key,key,key_size);
-        memcpy(information->value,value,value_size);
+/*
+ * In modul arena memoria unei intrari sterse se recupereaza abia la ht_free.
+ */
+static void ht_mem_free(hashtable_t *ht, void *ptr)
+{
+    if (!ht->use_arena)
+        free(ptr);
+}
 
-        ll_add_nth_node(ht->buckets[index], 0 ,information);
-        
-        free(information);
-        
+/*
+ * Elibereaza nodul unei intrari scoase din bucket. Daca exista iteratori
+ * activi, nodul e doar marcat ca sters si eliberarea se amana (vezi
+ * dead_nodes).
+ */
+static void ht_node_free(hashtable_t *ht, ll_node_t *node)
+{
+    if (ht->iterators == 0) {
+        ht_mem_free(ht, node);
+        return;
     }
-    else {
-        linked_list_t *entry = ht->buckets[index];
-        ll_node_t *curr = entry->head;
 
-        while (curr != NULL) {
-            info *data = curr->data;
-            if(ht->compare_function(data->key, key) == 0) 
-                memcpy(data->value, value, value_size);
+    node->data = NULL;
+    if (ht->use_arena)
+        return;
 
-            curr = curr->next;
-        }
+    if (ht->dead_count == ht->dead_cap) {
+        ht->dead_cap = ht->dead_cap ? 2 * ht->dead_cap : 16;
+        ht->dead_nodes = realloc(ht->dead_nodes,
+                                 ht->dead_cap * sizeof(ll_node_t*));
     }
-}//check
+    ht->dead_nodes[ht->dead_count++] = node;
+}
 
 /*
- * Procedura care elimina din hashtable intrarea asociata cheii key.
- * Atentie! Trebuie avuta grija la eliberarea intregii memorii folosite pentru o
- * intrare din hashtable (adica memoria pentru copia lui key --vezi observatia
- * de la procedura put--, pentru structura info si pentru structura Node din
- * lista inlantuita).
+ * Elibereaza nodurile a caror eliberare a fost amanata de iteratori.
  */
-void ht_remove_entry(hashtable_t *ht, void *key)
+static void ht_free_dead_nodes(hashtable_t *ht)
 {
-	__uint32_t index = ht->hash_function(key) % ht->hmax;
-    linked_list_t *entry = ht->buckets[index];
-    
-    ll_node_t *curr = entry->head;
-    __uint32_t poz = 0;
+    for (unsigned int i = 0; i < ht->dead_count; ++i)
+        free(ht->dead_nodes[i]);
+    ht->dead_count = 0;
+}
 
-    while( curr != NULL) {
-        info *data = curr->data;
-        if(ht->compare_function(data->key,key) == 0) {
-            ll_node_t *remove = ll_remove_nth_node(entry,poz);
-            info *information = remove->data;
-            free(information->key);
-            free(information->value);
-            free(information);
-            free(remove->data);
-            free(remove);
-            ht->size--;
-            return;
-        }
-        curr=curr->next;
-        poz++;
-    }
-    
-}//check
+/*
+ * Elibereaza structura info a unei intrari (si copiile cheii/valorii). In
+ * modul arena nu e nimic de eliberat individual.
+ */
+static void ht_free_info(hashtable_t *ht, info *information)
+{
+    if (!ht->use_arena)
+        ht->key_val_free_function(information);
+}
+
+static linked_list_t *ht_bucket_create(hashtable_t *ht)
+{
+    linked_list_t *list = ht_mem_alloc(ht, sizeof(linked_list_t));
+
+    list->head = NULL;
+    list->data_size = sizeof(info);
+    list->size = 0;
+
+    return list;
+}
 
 /*
- * Procedura care elibereaza memoria folosita de toate intrarile din hashtable,
- * dupa care elibereaza si memoria folosita pentru a stoca structura hashtable.
+ * Trece tabela in modul arena: toate alocarile pentru intrari se fac prin
+ * avansarea unui pointer in bucati de HT_ARENA_CHUNK octeti, iar ht_free
+ * elibereaza doar bucatile si array-urile de bucket-uri, fara sa parcurga
+ * intrarile. key_val_free_function nu mai este apelata, deci cheile si
+ * valorile nu trebuie sa detina alta memorie. Potrivit pentru tabele
+ * temporare; memoria intrarilor sterse se recupereaza doar la ht_free.
+ * Trebuie apelata pe o tabela goala; intoarce 0 la succes si -1 altfel.
  */
-void ht_free(hashtable_t *ht)
-{	
-    for (unsigned int i = 0 ;i < ht->hmax; ++i) {
-        ll_node_t *node = ht->buckets[i]->head;
-        while (node != NULL)
-        {
-            info *data = node->data;
-            free(data->key);
-            free(data->value);
-            //free(data);
-            node = node->next;
-        }
-        ll_free(&ht->buckets[i]);
-        
+int ht_enable_arena(hashtable_t *ht)
+{
+    if (ht == NULL || ht->size != 0 || ht->old_buckets != NULL)
+        return -1;
+
+    for (unsigned int i = 0; i < ht->hmax; ++i) {
+        if (ht->buckets[i] != NULL)
+            return -1;
     }
 
-    free(ht->buckets);
-    free(ht);
-}// check
+    ht->use_arena = 1;
+    return 0;
+}
 
-unsigned int ht_get_size(hashtable_t *ht)
+/*
+ * Intoarce adresa bucket-ului in care se afla (sau ar trebui sa se afle) o
+ * cheie cu hash-ul dat. In timpul redimensionarii, bucket-urile vechi care nu
+ * au fost inca mutate raman valabile, deci o cautare se uita intr-un singur loc.
+ */
+static linked_list_t **ht_bucket(hashtable_t *ht, unsigned int hash)
 {
-	if (ht == NULL)
-		return 0;
+    if (ht->old_buckets != NULL) {
+        unsigned int old_index = hash % ht->old_hmax;
+        if (old_index >= ht->rehash_idx)
+            return &ht->old_buckets[old_index];
+    }
 
-	return ht->size;
+    return &ht->buckets[hash % ht->hmax];
 }
 
-unsigned int ht_get_hmax(hashtable_t *ht)
+/*
+ * Blocul unui hash se alege din bitii superiori (multiply-shift), iar cei
+ * HT_BLOOM_K numaratori din bitii superiori ai lui hash * constanta, care
+ * depind de toti bitii hash-ului.
+ */
+static inline unsigned char *ht_bloom_block(ht_bloom_t *bloom, unsigned int hash)
 {
-	if (ht == NULL)
-		return 0;
-
-	return ht->hmax;
+    size_t block = ((uint64_t)hash * bloom->nblocks) >> 32;
+    return bloom->counters + block * HT_BLOOM_BLOCK;
 }
 
-struct FriendInfo {
-	char name[MAX_STRING_SIZE];
-	char faculty[MAX_STRING_SIZE];
-	char fav_food[MAX_STRING_SIZE];
-	int age;
-};
+static inline unsigned int ht_bloom_pos(unsigned int hash, int i)
+{
+    return ((hash * 0x9e3779b9u) >> (8 + 6 * i)) & (HT_BLOOM_BLOCK - 1);
+}
 
-static void print_friend(struct FriendInfo *f_info)
+static void ht_bloom_add(ht_bloom_t *bloom, unsigned int hash)
 {
-	if (f_info == NULL) {
+    unsigned char *block = ht_bloom_block(bloom, hash);
+
+    for (int i = 0; i < HT_BLOOM_K; ++i) {
+        unsigned char *counter = &block[ht_bloom_pos(hash, i)];
+        if (*counter != UINT8_MAX)
+            (*counter)++;
+    }
+}
+
+static void ht_bloom_remove(ht_bloom_t *bloom, unsigned int hash)
+{
+    unsigned char *block = ht_bloom_block(bloom, hash);
+
+    for (int i = 0; i < HT_BLOOM_K; ++i) {
+        unsigned char *counter = &block[ht_bloom_pos(hash, i)];
+        if (*counter != UINT8_MAX)
+            (*counter)--;
+    }
+}
+
+/*
+ * Intoarce 0 doar daca nicio cheie cu acest hash nu e in tabela. Atinge o
+ * singura linie de cache.
+ */
+static inline int ht_bloom_may_contain(hashtable_t *ht, unsigned int hash)
+{
+    if (ht->bloom == NULL)
+        return 1;
+
+    unsigned char *block = ht_bloom_block(ht->bloom, hash);
+    for (int i = 0; i < HT_BLOOM_K; ++i) {
+        if (block[ht_bloom_pos(hash, i)] == 0) {
+            ht->stats.bloom_rejects++;
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/*
+ * (Re)aloca filtrul pentru capacity chei si il reconstruieste din hash-urile
+ * pastrate in intrari, din ambele array-uri de bucket-uri.
+ */
+static void ht_bloom_rebuild(hashtable_t *ht, unsigned int capacity)
+{
+    ht_bloom_t *bloom = ht->bloom;
+    size_t nblocks = ((size_t)capacity * HT_BLOOM_PER_KEY + HT_BLOOM_BLOCK - 1)
+                     / HT_BLOOM_BLOCK;
+
+    free(bloom->counters);
+    bloom->counters = aligned_alloc(HT_BLOOM_BLOCK, nblocks * HT_BLOOM_BLOCK);
+    memset(bloom->counters, 0, nblocks * HT_BLOOM_BLOCK);
+    bloom->nblocks = nblocks;
+    bloom->capacity = capacity;
+
+    for (int pass = 0; pass < 2; ++pass) {
+        linked_list_t **buckets = pass ? ht->old_buckets : ht->buckets;
+        unsigned int hmax = pass ? ht->old_hmax : ht->hmax;
+
+        for (unsigned int i = 0; buckets != NULL && i < hmax; ++i) {
+            /* Bucket-urile vechi deja mutate sunt goale. */
+            if (buckets[i] == NULL)
+                continue;
+            for (ll_node_t *node = buckets[i]->head; node; node = node->next)
+                ht_bloom_add(bloom, ((info *)node->data)->hash);
+        }
+    }
+}
+
+/*
+ * Activeaza filtrul Bloom in fata cautarilor: ht_has_key, ht_get si
+ * ht_remove_entry pentru o cheie absenta se opresc (de cele mai multe ori)
+ * dupa o singura linie de cache, fara sa parcurga lantul si sa compare chei.
+ * expected e nr. estimat de chei; daca tabela il depaseste, filtrul se
+ * reconstruieste la dimensiune dubla. Intoarce 0 la succes si -1 altfel.
+ */
+int ht_enable_bloom(hashtable_t *ht, unsigned int expected)
+{
+    if (ht == NULL)
+        return -1;
+
+    if (ht->bloom == NULL)
+        ht->bloom = calloc(1, sizeof(ht_bloom_t));
+
+    if (expected < ht->size)
+        expected = ht->size;
+    if (expected < HT_BLOOM_BLOCK)
+        expected = HT_BLOOM_BLOCK;
+    ht_bloom_rebuild(ht, expected);
+
+    return 0;
+}
+
+static void ht_lru_unlink(hashtable_t *ht, info *information)
+{
+    if (information->lru_prev != NULL)
+        information->lru_prev->lru_next = information->lru_next;
+    else
+        ht->lru_head = information->lru_next;
+
+    if (information->lru_next != NULL)
+        information->lru_next->lru_prev = information->lru_prev;
+    else
+        ht->lru_tail = information->lru_prev;
+}
+
+static void ht_lru_push_front(hashtable_t *ht, info *information)
+{
+    information->lru_prev = NULL;
+    information->lru_next = ht->lru_head;
+    if (ht->lru_head != NULL)
+        ht->lru_head->lru_prev = information;
+    else
+        ht->lru_tail = information;
+    ht->lru_head = information;
+}
+
+/*
+ * Marcheaza intrarea ca folosita cel mai recent.
+ */
+static inline void ht_lru_touch(hashtable_t *ht, info *information)
+{
+    if (ht->capacity == 0 || ht->lru_head == information)
+        return;
+
+    ht_lru_unlink(ht, information);
+    ht_lru_push_front(ht, information);
+}
+
+/*
+ * Muta cel mult HT_REHASH_STEP bucket-uri din old_buckets in buckets. Nodurile
+ * sunt doar reinlantuite, nu realocate.
+ */
+static void ht_rehash_step(hashtable_t *ht)
+{
+    unsigned int steps = HT_REHASH_STEP;
+
+    if (ht->old_buckets == NULL || ht->iterators > 0)
+        return;
+
+    double start = now_sec();
+
+    while (steps > 0 && ht->rehash_idx < ht->old_hmax) {
+        linked_list_t *old = ht->old_buckets[ht->rehash_idx];
+
+        if (old != NULL) {
+            ll_node_t *node = old->head;
+            while (node != NULL) {
+                ll_node_t *next = node->next;
+                info *data = node->data;
+                unsigned int index = data->hash % ht->hmax;
+
+                if (ht->buckets[index] == NULL)
+                    ht->buckets[index] = ht_bucket_create(ht);
+                node->next = ht->buckets[index]->head;
+                ht->buckets[index]->head = node;
+                ht->buckets[index]->size++;
+
+                node = next;
+            }
+            ht_mem_free(ht, old);
+            ht->old_buckets[ht->rehash_idx] = NULL;
+        }
+
+        ht->rehash_idx++;
+        steps--;
+    }
+
+    double end = now_sec();
+    ht->stats.rehash_sec += end - start;
+    if (end - start > ht->stats.rehash_max_step_sec)
+        ht->stats.rehash_max_step_sec = end - start;
+
+    if (ht->rehash_idx == ht->old_hmax) {
+        free(ht->old_buckets);
+        ht->old_buckets = NULL;
+        ht->old_hmax = 0;
+        ht->rehash_idx = 0;
+        ht->stats.last_resize_sec = end - ht->stats.resize_start;
+    }
+}
+
+/*
+ * Incepe mutarea intrarilor intr-o tabela cu new_hmax bucket-uri. Mutarea
+ * propriu-zisa se face treptat, din ht_rehash_step.
+ */
+static void ht_start_resize(hashtable_t *ht, unsigned int new_hmax)
+{
+    if (ht->old_buckets != NULL)
+        return;
+
+    ht->old_buckets = ht->buckets;
+    ht->old_hmax = ht->hmax;
+    ht->rehash_idx = 0;
+
+    ht->buckets = calloc(new_hmax, sizeof(linked_list_t*));
+    ht->hmax = new_hmax;
+
+    ht->stats.resizes++;
+    ht->stats.resize_start = now_sec();
+}
+
+/*
+ * Verifica pragurile de incarcare dupa o modificare a lui size.
+ */
+static void ht_check_load(hashtable_t *ht)
+{
+    if (ht->old_buckets != NULL || ht->iterators > 0)
+        return;
+
+    if (ht->size > ht->hmax * HT_GROW_LOAD)
+        ht_start_resize(ht, ht->hmax * 2);
+    else if (ht->hmax / 2 >= ht->min_hmax &&
+             ht->size * HT_SHRINK_DIV < ht->hmax)
+        ht_start_resize(ht, ht->hmax / 2);
+}
+
+/*
+ * Functie care intoarce:
+ * 1, daca pentru cheia key a fost asociata anterior o valoare in hashtable
+ * folosind functia put;
+ * 0, altfel.
+ */
+int ht_has_key(hashtable_t *ht, void *key)
+{
+    unsigned int hash = ht_hash(ht, key);
+    if (!ht_bloom_may_contain(ht, hash))
+        return 0;
+
+    linked_list_t *entry_in = *ht_bucket(ht, hash);
+    unsigned int probes = 0;
+
+    if(entry_in == NULL) {
+        ht_record_probes(ht, 0);
+        return 0;
+    }
+    
+    ll_node_t *node = entry_in->head;
+    
+    while(node != NULL) {
+        info *information = node->data;
+        probes++;
+        
+        if(information->hash == hash &&
+           ht_keys_equal(ht, key, information->key)) {
+            ht_record_probes(ht, probes);
+            return 1;
+        }
+        
+        node = node->next;
+    }
+
+    ht_record_probes(ht, probes);
+	return 0;
+}//check
+
+/*
+ * Cauta cheia key, al carei hash e deja calculat, si intoarce intrarea ei.
+ */
+static info *ht_lookup_hashed(hashtable_t *ht, void *key, unsigned int hash)
+{
+    if (!ht_bloom_may_contain(ht, hash))
+        return NULL;
+
+    linked_list_t *entry = *ht_bucket(ht, hash);
+    unsigned int probes = 0;
+
+    if(entry == NULL) {
+        ht_record_probes(ht, 0);
+        return NULL;
+    }
+    
+    ll_node_t *node = entry->head;
+
+    while(node != NULL) {
+        info *information = node->data;
+        probes++;
+        if(information->hash == hash &&
+           ht_keys_equal(ht, key, information->key)) {
+            ht_record_probes(ht, probes);
+            return information;
+        }
+        node = node->next;
+    }
+
+    ht_record_probes(ht, probes);
+ 	return NULL;
+}
+
+/*
+ * In modul cache, o cautare reusita muta intrarea in capul listei de recenta.
+ */
+static void *ht_get_hashed(hashtable_t *ht, void *key, unsigned int hash)
+{
+    info *information = ht_lookup_hashed(ht, key, hash);
+
+    if (ht->capacity != 0) {
+        if (information == NULL) {
+            ht->stats.misses++;
+            return NULL;
+        }
+        ht->stats.hits++;
+        ht_lru_touch(ht, information);
+    }
+
+    return information ? information->value : NULL;
+}
+
+void *ht_get(hashtable_t *ht, void *key)
+{
+    return ht_get_hashed(ht, key, ht_hash(ht, key));
+}
+
+/*
+ * Aloca o structura info cu loc pentru o cheie de key_size octeti si o valoare
+ * de value_size octeti. Cele sub inline_max octeti se pun in acelasi bloc,
+ * dupa structura (aliniate la 8 octeti), celelalte se aloca separat.
+ */
+static info *ht_alloc_info(hashtable_t *ht, unsigned int key_size,
+	unsigned int value_size)
+{
+    size_t key_inline = key_size <= ht->inline_max ? (key_size + 7) & ~7u : 0;
+    size_t value_inline = value_size <= ht->inline_max ? value_size : 0;
+    size_t head = (sizeof(info) + 7) & ~(size_t)7;
+    char *block = ht_mem_alloc(ht, head + key_inline + value_inline);
+    info *information = (info *)block;
+
+    information->flags = 0;
+    information->key_size = key_size;
+    information->value_size = value_size;
+    if (key_size <= ht->inline_max) {
+        information->key = block + head;
+        information->flags |= HT_KEY_INLINE;
+    } else {
+        information->key = ht_mem_alloc(ht, key_size);
+    }
+
+    if (value_size <= ht->inline_max) {
+        information->value = block + head + key_inline;
+        information->flags |= HT_VALUE_INLINE;
+    } else {
+        information->value = ht_mem_alloc(ht, value_size);
+    }
+
+    return information;
+}
+
+static void ht_evict(hashtable_t *ht);
+
+/*
+ * Cauta cheia key si, daca nu exista, creeaza direct in bucket o intrare noua
+ * cu o copie a cheii si loc pentru value_size octeti de valoare (neinitializati).
+ * Intoarce structura info a intrarii, in a carei valoare apelantul scrie.
+ * *inserted devine 1 daca intrarea e noua si 0 daca exista deja.
+ *
+ * Spre deosebire de ht_has_key urmat de ll_add_nth_node, cheia e hash-uita o
+ * singura data, bucket-ul e parcurs o singura data si nu se aloca nicio
+ * structura info temporara.
+ */
+static info *ht_find_or_insert_hashed(hashtable_t *ht, void *key,
+	unsigned int hash, unsigned int key_size, unsigned int value_size,
+	int *inserted)
+{
+    ht_rehash_step(ht);
+
+    linked_list_t **bucket = ht_bucket(ht, hash);
+    unsigned int probes = 0;
+    ht->upsert_calls++;
+
+    if (*bucket == NULL) {
+        *bucket = ht_bucket_create(ht);
+    } else if (ht_bloom_may_contain(ht, hash)) {
+        ll_node_t *node = (*bucket)->head;
+        while (node != NULL) {
+            info *information = node->data;
+            probes++;
+            if (information->hash == hash &&
+                ht_keys_equal(ht, key, information->key)) {
+                ht->upsert_probes += probes;
+                ht->upsert_legacy_probes += probes + (*bucket)->size;
+                ht_record_probes(ht, probes);
+                ht_lru_touch(ht, information);
+                *inserted = 0;
+                return information;
+            }
+            node = node->next;
+        }
+    }
+    ht->upsert_probes += probes;
+    ht->upsert_legacy_probes += (*bucket)->size;
+    ht_record_probes(ht, probes);
+
+    info *information = ht_alloc_info(ht, key_size, value_size);
+    memcpy(information->key, key, key_size);
+    information->hash = hash;
+
+    ll_node_t *new_node = ht_mem_alloc(ht, sizeof(ll_node_t));
+    new_node->data = information;
+    new_node->next = (*bucket)->head;
+    (*bucket)->head = new_node;
+    (*bucket)->size++;
+
+    ht->size++;
+    *inserted = 1;
+    if (ht->capacity != 0) {
+        ht_lru_push_front(ht, information);
+        if (ht->size > ht->capacity)
+            ht_evict(ht);
+    }
+    if (ht->bloom != NULL) {
+        if (ht->size > ht->bloom->capacity)
+            ht_bloom_rebuild(ht, 2 * ht->bloom->capacity);
+        else
+            ht_bloom_add(ht->bloom, hash);
+    }
+    ht_check_load(ht);
+
+    return information;
+}
+
+info *ht_find_or_insert(hashtable_t *ht, void *key, unsigned int key_size,
+	unsigned int value_size, int *inserted)
+{
+    return ht_find_or_insert_hashed(ht, key, ht_hash(ht, key), key_size,
+                                    value_size, inserted);
+}
+
+/*
+ * Atentie! Desi cheia este trimisa ca un void pointer (deoarece nu se impune
+ * tipul ei), in momentul in care se creeaza o noua intrare in hashtable (in
+ * cazul in care cheia nu se gaseste deja in ht), trebuie creata o copie a
+ * valorii la care pointeaza key si adresa acestei copii trebuie salvata in
+ * structura info asociata intrarii din ht. Pentru a sti cati octeti trebuie
+ * alocati si copiati, folositi parametrul key_size.
+ *
+ * Motivatie:
+ * Este nevoie sa copiem valoarea la care pointeaza key deoarece dupa un apel
+ * put(ht, key_actual, value_actual), valoarea la care pointeaza key_actual
+ * poate fi alterata (de ex: *key_actual++). Daca am folosi direct adresa
+ * pointerului key_actual, practic s-ar modifica din afara hashtable-ului cheia
+ * unei intrari din hashtable. Nu ne dorim acest lucru, fiindca exista riscul sa
+ * ajungem in situatia in care nu mai stim la ce cheie este inregistrata o
+ * anumita valoare.
+ */
+void ht_put(hashtable_t *ht, void *key, unsigned int key_size,
+	void *value, unsigned int value_size)
+{
+    int inserted;
+    info *slot = ht_find_or_insert(ht, key, key_size, value_size, &inserted);
+
+    memcpy(slot->value, value, value_size);
+}//check
+
+/*
+ * Cate chei dintr-un lot se pregatesc deodata in ht_get_many/ht_put_many.
+ * Trebuie sa fie destule cat sa acopere latenta memoriei, dar putine cat
+ * liniile aduse cu prefetch sa nu fie evacuate inainte de folosire.
+ */
+#define HT_BATCH 16
+
+/*
+ * Calculeaza hash-urile pentru keys[0..n) si aduce in cache, in etape,
+ * bucket-ul, lista si primul nod din lant pentru fiecare cheie. Fiecare etapa
+ * lanseaza n cereri de memorie independente, deci latentele lor se suprapun in
+ * loc sa se adune ca la n apeluri ht_get succesive.
+ */
+static void ht_prefetch_batch(hashtable_t *ht, void **keys, unsigned int n,
+	unsigned int *hashes)
+{
+    linked_list_t **slots[HT_BATCH];
+    linked_list_t *lists[HT_BATCH];
+
+    for (unsigned int i = 0; i < n; ++i) {
+        hashes[i] = ht_hash(ht, keys[i]);
+        slots[i] = ht_bucket(ht, hashes[i]);
+        __builtin_prefetch(slots[i]);
+    }
+
+    for (unsigned int i = 0; i < n; ++i) {
+        lists[i] = *slots[i];
+        if (lists[i] != NULL)
+            __builtin_prefetch(lists[i]);
+    }
+
+    for (unsigned int i = 0; i < n; ++i) {
+        if (lists[i] != NULL && lists[i]->head != NULL)
+            __builtin_prefetch(lists[i]->head);
+    }
+
+    for (unsigned int i = 0; i < n; ++i) {
+        if (lists[i] != NULL && lists[i]->head != NULL)
+            __builtin_prefetch(lists[i]->head->data);
+    }
+}
+
+/*
+ * Echivalent cu values[i] = ht_get(ht, keys[i]) pentru i = 0..n-1, dar cheile
+ * se proceseaza in loturi de HT_BATCH, cu prefetch pentru tot lotul inainte de
+ * cautari.
+ */
+void ht_get_many(hashtable_t *ht, void **keys, unsigned int n, void **values)
+{
+    unsigned int hashes[HT_BATCH];
+
+    for (unsigned int start = 0; start < n; start += HT_BATCH) {
+        unsigned int count = n - start < HT_BATCH ? n - start : HT_BATCH;
+
+        ht_prefetch_batch(ht, keys + start, count, hashes);
+        for (unsigned int i = 0; i < count; ++i)
+            values[start + i] = ht_get_hashed(ht, keys[start + i], hashes[i]);
+    }
+}
+
+/*
+ * Echivalent cu ht_put(ht, keys[i], key_sizes[i], values[i], value_sizes[i])
+ * pentru i = 0..n-1, in loturi de HT_BATCH cu prefetch.
+ */
+void ht_put_many(hashtable_t *ht, void **keys, unsigned int *key_sizes,
+	void **values, unsigned int *value_sizes, unsigned int n)
+{
+    unsigned int hashes[HT_BATCH];
+    int inserted;
+
+    for (unsigned int start = 0; start < n; start += HT_BATCH) {
+        unsigned int count = n - start < HT_BATCH ? n - start : HT_BATCH;
+
+        ht_prefetch_batch(ht, keys + start, count, hashes);
+        for (unsigned int i = 0; i < count; ++i) {
+            unsigned int k = start + i;
+            info *slot = ht_find_or_insert_hashed(ht, keys[k], hashes[i],
+                                                  key_sizes[k], value_sizes[k],
+                                                  &inserted);
+            memcpy(slot->value, values[k], value_sizes[k]);
+        }
+    }
+}
+
+/*
+ * Procedura care elimina din hashtable intrarea asociata cheii key.
+ * Atentie! Trebuie avuta grija la eliberarea intregii memorii folosite pentru o
+ * intrare din hashtable (adica memoria pentru copia lui key --vezi observatia
+ * de la procedura put--, pentru structura info si pentru structura Node din
+ * lista inlantuita).
+ */
+static void ht_remove_hashed(hashtable_t *ht, void *key, unsigned int hash)
+{
+    ht_rehash_step(ht);
+
+    if (!ht_bloom_may_contain(ht, hash))
+        return;
+
+    linked_list_t *entry = *ht_bucket(ht, hash);
+
+    if (entry == NULL) {
+        ht_record_probes(ht, 0);
+        return;
+    }
+    
+    ll_node_t *curr = entry->head;
+    __uint32_t poz = 0;
+
+    while( curr != NULL) {
+        info *data = curr->data;
+        if(data->hash == hash && ht_keys_equal(ht, data->key, key)) {
+            ht_record_probes(ht, poz + 1);
+            if (ht->capacity != 0)
+                ht_lru_unlink(ht, data);
+            ll_node_t *remove = ll_remove_nth_node(entry,poz);
+            /* Elibereaza cheia, valoarea si structura info (remove->data). */
+            ht_free_info(ht, remove->data);
+            ht_node_free(ht, remove);
+            ht->size--;
+            if (ht->bloom != NULL)
+                ht_bloom_remove(ht->bloom, hash);
+            ht_check_load(ht);
+            return;
+        }
+        curr=curr->next;
+        poz++;
+    }
+
+    ht_record_probes(ht, poz);
+}
+
+void ht_remove_entry(hashtable_t *ht, void *key)
+{
+    ht_remove_hashed(ht, key, ht_hash(ht, key));
+}//check
+
+/*
+ * Evacueaza intrarea folosita cel mai de demult (coada listei de recenta).
+ */
+static void ht_evict(hashtable_t *ht)
+{
+    info *victim = ht->lru_tail;
+
+    if (victim == NULL)
+        return;
+
+    ht->stats.evictions++;
+    ht_remove_hashed(ht, victim->key, victim->hash);
+}
+
+/*
+ * Trece tabela in modul cache: cel mult capacity intrari, iar la depasire se
+ * evacueaza intrarea folosita cel mai de demult. ht_get si ht_put (pe o cheie
+ * existenta) o marcheaza ca folosita; ht_has_key nu. Toate operatiile raman
+ * O(1). Intrarile deja existente intra in lista in ordinea bucket-urilor, iar
+ * surplusul se evacueaza imediat. capacity == 0 dezactiveaza modul cache.
+ */
+void ht_set_capacity(hashtable_t *ht, unsigned int capacity)
+{
+    if (ht == NULL)
+        return;
+
+    if (ht->capacity == 0 && capacity != 0) {
+        ht->lru_head = NULL;
+        ht->lru_tail = NULL;
+        for (int pass = 0; pass < 2; ++pass) {
+            linked_list_t **buckets = pass ? ht->old_buckets : ht->buckets;
+            unsigned int hmax = pass ? ht->old_hmax : ht->hmax;
+
+            for (unsigned int i = 0; buckets != NULL && i < hmax; ++i) {
+                if (buckets[i] == NULL)
+                    continue;
+                for (ll_node_t *node = buckets[i]->head; node; node = node->next)
+                    ht_lru_push_front(ht, node->data);
+            }
+        }
+    }
+
+    ht->capacity = capacity;
+    while (capacity != 0 && ht->size > capacity)
+        ht_evict(ht);
+}
+
+/*
+ * Elibereaza toate listele dintr-un array de bucket-uri si array-ul insusi.
+ */
+static void ht_free_buckets(hashtable_t *ht, linked_list_t **buckets,
+	unsigned int hmax)
+{
+    for (unsigned int i = 0 ;i < hmax && !ht->use_arena; ++i) {
+        if (buckets[i] == NULL)
+            continue;
+
+        ll_node_t *node = buckets[i]->head;
+        while (node != NULL)
+        {
+            ll_node_t *next = node->next;
+            ht->key_val_free_function(node->data);
+            free(node);
+            node = next;
+        }
+        free(buckets[i]);
+        
+    }
+
+    free(buckets);
+}
+
+/*
+ * Procedura care elibereaza memoria folosita de toate intrarile din hashtable,
+ * dupa care elibereaza si memoria folosita pentru a stoca structura hashtable.
+ */
+void ht_free(hashtable_t *ht)
+{	
+    /* In modul arena ht_free_buckets elibereaza doar array-urile. */
+    ht_free_buckets(ht, ht->buckets, ht->hmax);
+    if (ht->old_buckets != NULL)
+        ht_free_buckets(ht, ht->old_buckets, ht->old_hmax);
+    ht_free_dead_nodes(ht);
+    free(ht->dead_nodes);
+
+    while (ht->arena != NULL) {
+        ht_arena_chunk_t *next = ht->arena->next;
+        free(ht->arena);
+        ht->arena = next;
+    }
+
+    if (ht->bloom != NULL) {
+        free(ht->bloom->counters);
+        free(ht->bloom);
+    }
+
+    free(ht);
+}// check
+
+/*
+ * Dimensioneaza tabela pentru cel putin n intrari, ca inserarea lor sa nu mai
+ * declanseze redimensionari, si nu o mai lasa sa scada sub aceasta dimensiune.
+ * O redimensionare in curs se termina inainte. Intoarce 0 la succes si -1 daca
+ * exista iteratori activi.
+ */
+int ht_reserve(hashtable_t *ht, unsigned int n)
+{
+    if (ht == NULL || ht->iterators > 0)
+        return -1;
+
+    while (ht->old_buckets != NULL)
+        ht_rehash_step(ht);
+
+    unsigned int want = (n + HT_GROW_LOAD - 1) / HT_GROW_LOAD;
+    if (want <= ht->hmax)
+        return 0;
+
+    if (ht->size == 0) {
+        ht_free_buckets(ht, ht->buckets, ht->hmax);
+        ht->buckets = calloc(want, sizeof(linked_list_t*));
+        ht->hmax = want;
+    } else {
+        ht_start_resize(ht, want);
+        while (ht->old_buckets != NULL)
+            ht_rehash_step(ht);
+    }
+    ht->min_hmax = want;
+
+    return 0;
+}
+
+unsigned int ht_get_size(hashtable_t *ht)
+{
+	if (ht == NULL)
+		return 0;
+
+	return ht->size;
+}
+
+unsigned int ht_get_hmax(hashtable_t *ht)
+{
+	if (ht == NULL)
+		return 0;
+
+	return ht->hmax;
+}
+
+/*
+ * Schimba pragul sub care cheile si valorile se pastreaza in blocul lui info.
+ * 0 dezactiveaza stocarea inline. Afecteaza doar intrarile create ulterior.
+ */
+void ht_set_inline_max(hashtable_t *ht, unsigned int inline_max)
+{
+	if (ht == NULL)
+		return;
+
+	ht->inline_max = inline_max;
+}
+
+/*
+ * Afiseaza cate noduri au fost comparate, in medie, la un put, si cate ar fi
+ * vizitat aceleasi put-uri pe drumul vechi (ht_has_key + a doua parcurgere).
+ */
+void ht_print_put_stats(hashtable_t *ht)
+{
+    if (ht == NULL)
+        return;
+
+    double calls = ht->upsert_calls ? ht->upsert_calls : 1;
+
+    printf("Puts: %lu | Probes: %lu | Probes/put: %.2f\n", ht->upsert_calls,
+           ht->upsert_probes, ht->upsert_probes / calls);
+    printf("Old path (has_key + second walk): Probes: %lu | Probes/put: %.2f\n",
+           ht->upsert_legacy_probes, ht->upsert_legacy_probes / calls);
+}
+
+static void ht_print_hist(const char *title, const unsigned long *hist)
+{
+    static const char *labels[HT_HIST_SIZE] = {"0", "1", "2", "3", "4",
+                                               "5-8", "9-16", "17+"};
+
+    printf("%s:", title);
+    for (unsigned int i = 0; i < HT_HIST_SIZE; ++i)
+        printf(" [%s] %lu", labels[i], hist[i]);
+    printf("\n");
+}
+
+/*
+ * Afiseaza distributia lungimilor lanturilor (calculata acum, parcurgand
+ * bucket-urile), histograma nr. de noduri vizitate per cautare, nr. de apeluri
+ * ale comparatorului si timpii de redimensionare.
+ */
+void ht_print_stats(hashtable_t *ht)
+{
+    unsigned long chains[HT_HIST_SIZE] = {0};
+    unsigned long max_chain = 0, used = 0;
+
+    if (ht == NULL)
+        return;
+
+    for (int pass = 0; pass < 2; ++pass) {
+        linked_list_t **buckets = pass ? ht->old_buckets : ht->buckets;
+        unsigned int hmax = pass ? ht->old_hmax : ht->hmax;
+
+        for (unsigned int i = 0; buckets != NULL && i < hmax; ++i) {
+            /* Bucket-urile vechi deja mutate nu mai fac parte din tabela. */
+            if (pass && i < ht->rehash_idx)
+                continue;
+
+            unsigned long len = buckets[i] ? buckets[i]->size : 0;
+            chains[ht_hist_index(len)]++;
+            if (len > 0)
+                used++;
+            if (len > max_chain)
+                max_chain = len;
+        }
+    }
+
+    const ht_stats_t *st = &ht->stats;
+    unsigned long probes = 0;
+    for (unsigned int i = 0; i < HT_HIST_SIZE; ++i)
+        probes += st->probe_hist[i];
+
+    printf("Size: %u | Buckets: %u | Load: %.2f | Used buckets: %lu\n",
+           ht->size, ht->hmax, (double)ht->size / ht->hmax, used);
+    printf("Max chain: %lu | Mean chain (used buckets): %.2f\n", max_chain,
+           used ? (double)ht->size / used : 0.0);
+    ht_print_hist("Chain lengths", chains);
+    ht_print_hist("Probes per lookup", st->probe_hist);
+    printf("Lookups: %lu | Compares: %lu | Compares/lookup: %.2f\n",
+           st->lookups, st->compares,
+           st->lookups ? (double)st->compares / st->lookups : 0.0);
+    if (ht->bloom != NULL)
+        printf("Bloom: %u blocks | Rejected lookups: %lu\n",
+               ht->bloom->nblocks, st->bloom_rejects);
+    if (ht->capacity != 0)
+        printf("Cache capacity: %u | Hits: %lu | Misses: %lu | "
+               "Evictions: %lu\n", ht->capacity, st->hits, st->misses,
+               st->evictions);
+    printf("Resizes: %lu | Rehash time: %.3f ms | Max step: %.3f us | "
+           "Last resize: %.3f ms\n", st->resizes, st->rehash_sec * 1e3,
+           st->rehash_max_step_sec * 1e6, st->last_resize_sec * 1e3);
+}
+
+/*
+ * Pool de string-uri internate. Fiecare string distinct se copiaza o singura
+ * data, intr-un arena; ht_intern intoarce mereu acelasi pointer (handle) pentru
+ * acelasi continut. Doua handle-uri sunt egale daca si numai daca string-urile
+ * sunt egale, deci tabelele cu chei internate compara si hash-uiesc doar
+ * pointerul (vezi hash_function_interned / compare_function_interned), iar
+ * valorile pot tine handle-uri de 8 octeti in loc de array-uri de caractere.
+ * Handle-urile sunt valabile pana la ht_intern_free.
+ */
+typedef struct ht_intern_pool_t ht_intern_pool_t;
+struct ht_intern_pool_t {
+	/* Adresare deschisa, sondare liniara; NULL inseamna slot liber. */
+	const char **slots;
+	unsigned int *hashes;
+	unsigned int mask;
+	unsigned int count;
+	size_t bytes; /* Octetii ocupati de string-uri (cu '\0'). */
+	ht_arena_chunk_t *arena;
+};
+
+/* Nr. initial de sloturi din pool (putere a lui 2). */
+#define HT_INTERN_INIT_SLOTS	64
+
+ht_intern_pool_t *ht_intern_create(void)
+{
+    ht_intern_pool_t *pool = calloc(1, sizeof(ht_intern_pool_t));
+
+    pool->mask = HT_INTERN_INIT_SLOTS - 1;
+    pool->slots = calloc(pool->mask + 1, sizeof(const char*));
+    pool->hashes = malloc((pool->mask + 1) * sizeof(unsigned int));
+
+    return pool;
+}
+
+static void ht_intern_grow(ht_intern_pool_t *pool)
+{
+    unsigned int old_cap = pool->mask + 1;
+    const char **old_slots = pool->slots;
+    unsigned int *old_hashes = pool->hashes;
+
+    pool->mask = 2 * old_cap - 1;
+    pool->slots = calloc(2 * old_cap, sizeof(const char*));
+    pool->hashes = malloc(2 * old_cap * sizeof(unsigned int));
+
+    for (unsigned int i = 0; i < old_cap; ++i) {
+        if (old_slots[i] == NULL)
+            continue;
+        unsigned int j = old_hashes[i] & pool->mask;
+        while (pool->slots[j] != NULL)
+            j = (j + 1) & pool->mask;
+        pool->slots[j] = old_slots[i];
+        pool->hashes[j] = old_hashes[i];
+    }
+
+    free(old_slots);
+    free(old_hashes);
+}
+
+/*
+ * Intoarce handle-ul string-ului s, adaugandu-l in pool daca e nou.
+ */
+const char *ht_intern(ht_intern_pool_t *pool, const char *s)
+{
+    size_t len = strlen(s);
+    uint64_t h64 = hash_len_wyhash(s, len, 0);
+    unsigned int hash = (unsigned int)(h64 ^ (h64 >> 32));
+    unsigned int i = hash & pool->mask;
+
+    for (; pool->slots[i] != NULL; i = (i + 1) & pool->mask) {
+        if (pool->hashes[i] == hash && strcmp(pool->slots[i], s) == 0)
+            return pool->slots[i];
+    }
+
+    char *copy = ht_arena_alloc(&pool->arena, len + 1);
+    memcpy(copy, s, len + 1);
+    pool->slots[i] = copy;
+    pool->hashes[i] = hash;
+    pool->count++;
+    pool->bytes += len + 1;
+
+    /* Factor de incarcare maxim 1/2. */
+    if (2 * pool->count > pool->mask + 1)
+        ht_intern_grow(pool);
+
+    return copy;
+}
+
+unsigned int ht_intern_count(ht_intern_pool_t *pool)
+{
+    if (pool == NULL)
+        return 0;
+
+    return pool->count;
+}
+
+void ht_intern_free(ht_intern_pool_t *pool)
+{
+    if (pool == NULL)
+        return;
+
+    while (pool->arena != NULL) {
+        ht_arena_chunk_t *next = pool->arena->next;
+        free(pool->arena);
+        pool->arena = next;
+    }
+
+    free(pool->slots);
+    free(pool->hashes);
+    free(pool);
+}
+
+/*
+ * Functii de hashing si comparare pentru chei care sunt handle-uri internate
+ * (key = adresa unui const char*, key_size = sizeof(const char*)).
+ */
+unsigned int hash_function_interned(void *a)
+{
+	uint64_t p = (uintptr_t)*(const char **)a;
+
+	p = (p ^ (p >> 32)) * 0x9e3779b97f4a7c15ull;
+	return (unsigned int)(p >> 32);
+}
+
+int compare_function_interned(void *a, void *b)
+{
+	const char *str_a = *(const char **)a;
+	const char *str_b = *(const char **)b;
+
+	if (str_a == str_b)
+		return 0;
+
+	return str_a < str_b ? -1 : 1;
+}
+
+/*
+ * Iterator peste toate intrarile unui hashtable. Cat timp exista un iterator
+ * activ, tabela nu se redimensioneaza si nu muta noduri intre bucket-uri,
+ * deci fiecare intrare existenta pe toata durata parcurgerii e intoarsa exact
+ * o data, chiar daca intre timp se fac put-uri si remove-uri (inclusiv
+ * evacuari in modul cache). Orice intrare, si cea intoarsa ultima, poate fi
+ * stearsa; o intrare stearsa nu mai e intoarsa. Intrarile adaugate in timpul
+ * parcurgerii pot sau nu sa fie vizitate.
+ */
+typedef struct ht_iterator_t ht_iterator_t;
+struct ht_iterator_t {
+	hashtable_t *ht;
+	int pass; /* 0: buckets, 1: old_buckets, 2: gata. */
+	unsigned int index; /* Urmatorul bucket de vizitat. */
+	/*
+	 * Urmatorul nod; retinut inainte de a intoarce curentul. Daca e sters
+	 * intre timp, ramane alocat cu data == NULL si e sarit.
+	 */
+	ll_node_t *next;
+};
+
+typedef struct ht_pair_t ht_pair_t;
+struct ht_pair_t {
+	void *key;
+	void *value;
+};
+
+void ht_iter_init(hashtable_t *ht, ht_iterator_t *it)
+{
+    it->ht = ht;
+    it->pass = 0;
+    it->index = 0;
+    it->next = NULL;
+    ht->iterators++;
+}
+
+/*
+ * Intoarce urmatoarea intrare (cheia si valoarea sunt in info, nu copii) sau
+ * NULL cand nu mai sunt intrari.
+ */
+info *ht_iter_next(ht_iterator_t *it)
+{
+    hashtable_t *ht = it->ht;
+    ll_node_t *node;
+
+    do {
+        while (it->next == NULL && it->pass < 2) {
+            linked_list_t **buckets = it->pass ? ht->old_buckets : ht->buckets;
+            unsigned int hmax = it->pass ? ht->old_hmax : ht->hmax;
+
+            if (buckets == NULL || it->index >= hmax) {
+                it->pass++;
+                it->index = 0;
+                continue;
+            }
+
+            if (buckets[it->index] != NULL)
+                it->next = buckets[it->index]->head;
+            it->index++;
+        }
+
+        if (it->next == NULL)
+            return NULL;
+
+        node = it->next;
+        it->next = node->next;
+    } while (node->data == NULL);
+
+    return node->data;
+}
+
+/*
+ * Trebuie apelata la finalul parcurgerii: reia redimensionarea tabelei si
+ * elibereaza nodurile sterse cat timp a fost activa.
+ */
+void ht_iter_release(ht_iterator_t *it)
+{
+    hashtable_t *ht = it->ht;
+
+    ht->iterators--;
+    if (ht->iterators == 0)
+        ht_free_dead_nodes(ht);
+    ht_check_load(ht);
+}
+
+/*
+ * Scrie in out (cel mult cap perechi) pointerii spre cheile si valorile din
+ * tabela, fara sa le copieze. Pointerii raman valizi pana la urmatoarea
+ * modificare a intrarilor respective. Intoarce nr. de perechi scrise.
+ */
+unsigned int ht_export(hashtable_t *ht, ht_pair_t *out, unsigned int cap)
+{
+    ht_iterator_t it;
+    unsigned int count = 0;
+    info *information;
+
+    ht_iter_init(ht, &it);
+    while (count < cap && (information = ht_iter_next(&it)) != NULL) {
+        out[count].key = information->key;
+        out[count].value = information->value;
+        count++;
+    }
+    ht_iter_release(&it);
+
+    return count;
+}
+
+static int ht_pair_compare(const void *a, const void *b, void *arg)
+{
+    const ht_pair_t *pa = a, *pb = b;
+
+    return ht_keys_compare(arg, pa->key, pb->key);
+}
+
+/*
+ * La fel ca ht_export, dar perechile sunt sortate crescator dupa cheie, cu
+ * compare_function (sau memcmp pe key_len octeti, strcmp daca key_len == 0).
+ */
+unsigned int ht_export_sorted(hashtable_t *ht, ht_pair_t *out, unsigned int cap)
+{
+    unsigned int count = ht_export(ht, out, cap);
+
+    qsort_r(out, count, sizeof(ht_pair_t), ht_pair_compare, ht);
+    return count;
+}
+
+/*
+ * Snapshot persistent al unui hashtable, care se deschide cu mmap si se
+ * interogheaza direct, fara sa fie reconstruit cu ht_put. Fisierul contine doar
+ * offset-uri fata de inceputul lui (nu pointeri), deci poate fi mapat la orice
+ * adresa:
+ *
+ *   ht_snapshot_header_t
+ *   uint32_t bucket_start[nbuckets + 1]   intrarile bucket-ului b sunt
+ *                                         entries[bucket_start[b] ..
+ *                                                 bucket_start[b + 1])
+ *   ht_snapshot_entry_t entries[size]     sortate dupa bucket
+ *   cheile si valorile, fiecare aliniata la 8 octeti
+ *
+ * Intrarile unui bucket sunt consecutive, deci o cautare citeste un interval
+ * continuu in loc sa urmareasca pointeri. La deschidere trebuie folosite
+ * aceleasi functii de hash si comparare ca la salvare.
+ */
+#define HT_SNAPSHOT_MAGIC	"HTSNAP01"
+#define HT_SNAPSHOT_ENDIAN	0x01020304u
+
+typedef struct ht_snapshot_header_t ht_snapshot_header_t;
+struct ht_snapshot_header_t {
+	char magic[8];
+	uint32_t endian;
+	uint32_t nbuckets;
+	uint64_t size;
+	uint64_t seed;
+	uint32_t key_len;
+	uint32_t reserved;
+	uint64_t entries_off;
+	uint64_t file_size;
+};
+
+typedef struct ht_snapshot_entry_t ht_snapshot_entry_t;
+struct ht_snapshot_entry_t {
+	uint32_t hash;
+	uint32_t key_size;
+	uint32_t value_size;
+	uint32_t reserved;
+	uint64_t key_off;
+	uint64_t value_off;
+};
+
+typedef struct ht_snapshot_t ht_snapshot_t;
+struct ht_snapshot_t {
+	const char *base; /* Inceputul maparii. */
+	size_t length;
+	const ht_snapshot_header_t *header;
+	const uint32_t *bucket_start;
+	const ht_snapshot_entry_t *entries;
+	/* Doar campurile de hashing si comparare sunt folosite (ht_hash etc.). */
+	hashtable_t cfg;
+};
+
+static uint64_t ht_align8(uint64_t off)
+{
+    return (off + 7) & ~(uint64_t)7;
+}
+
+/*
+ * Pune in out pointerii spre toate intrarile din ht. out trebuie sa aiba
+ * ht->size + 1 locuri (ultimul primeste NULL).
+ */
+static void ht_collect_entries(hashtable_t *ht, info **out)
+{
+    ht_iterator_t it;
+    unsigned int count = 0;
+
+    ht_iter_init(ht, &it);
+    while ((out[count] = ht_iter_next(&it)) != NULL)
+        count++;
+    ht_iter_release(&it);
+}
+
+/*
+ * Scrie hashtable-ul in fisierul path, in formatul descris mai sus.
+ * Intoarce 0 la succes si -1 la eroare.
+ */
+int ht_save_snapshot(hashtable_t *ht, const char *path)
+{
+    unsigned int nbuckets = ht->size ? ht->size : 1;
+    info **entries = malloc((ht->size + 1) * sizeof(info*));
+    info **sorted = malloc((ht->size ? ht->size : 1) * sizeof(info*));
+    uint32_t *bucket_start = calloc(nbuckets + 1, sizeof(uint32_t));
+    ht_snapshot_header_t header;
+    FILE *file = fopen(path, "wb");
+    int ret = 0;
+
+    if (file == NULL) {
+        free(bucket_start);
+        free(sorted);
+        free(entries);
+        return -1;
+    }
+
+    /* Sortare prin numarare dupa bucket-ul din snapshot. */
+    ht_collect_entries(ht, entries);
+    for (unsigned int i = 0; i < ht->size; ++i)
+        bucket_start[entries[i]->hash % nbuckets + 1]++;
+    for (unsigned int b = 0; b < nbuckets; ++b)
+        bucket_start[b + 1] += bucket_start[b];
+    for (unsigned int i = 0; i < ht->size; ++i) {
+        unsigned int b = entries[i]->hash % nbuckets;
+        sorted[bucket_start[b]++] = entries[i];
+    }
+    for (unsigned int b = nbuckets; b > 0; --b)
+        bucket_start[b] = bucket_start[b - 1];
+    bucket_start[0] = 0;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, HT_SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.endian = HT_SNAPSHOT_ENDIAN;
+    header.nbuckets = nbuckets;
+    header.size = ht->size;
+    header.seed = ht->seed;
+    header.key_len = ht->key_len;
+    header.entries_off = ht_align8(sizeof(header) +
+                                   (nbuckets + 1) * sizeof(uint32_t));
+
+    uint64_t data_off = header.entries_off +
+                        (uint64_t)ht->size * sizeof(ht_snapshot_entry_t);
+    uint64_t off = data_off;
+    for (unsigned int i = 0; i < ht->size; ++i)
+        off = ht_align8(ht_align8(off + sorted[i]->key_size) +
+                        sorted[i]->value_size);
+    header.file_size = off;
+
+    fwrite(&header, sizeof(header), 1, file);
+    fwrite(bucket_start, sizeof(uint32_t), nbuckets + 1, file);
+    for (uint64_t pos = sizeof(header) + (nbuckets + 1) * sizeof(uint32_t);
+         pos < header.entries_off; ++pos)
+        fputc(0, file);
+
+    off = data_off;
+    for (unsigned int i = 0; i < ht->size; ++i) {
+        ht_snapshot_entry_t entry = {0};
+        entry.hash = sorted[i]->hash;
+        entry.key_size = sorted[i]->key_size;
+        entry.value_size = sorted[i]->value_size;
+        entry.key_off = off;
+        entry.value_off = ht_align8(off + entry.key_size);
+        off = ht_align8(entry.value_off + entry.value_size);
+        fwrite(&entry, sizeof(entry), 1, file);
+    }
+
+    static const char zeros[8];
+    off = data_off;
+    for (unsigned int i = 0; i < ht->size; ++i) {
+        uint64_t value_off = ht_align8(off + sorted[i]->key_size);
+        fwrite(sorted[i]->key, 1, sorted[i]->key_size, file);
+        fwrite(zeros, 1, value_off - off - sorted[i]->key_size, file);
+        off = ht_align8(value_off + sorted[i]->value_size);
+        fwrite(sorted[i]->value, 1, sorted[i]->value_size, file);
+        fwrite(zeros, 1, off - value_off - sorted[i]->value_size, file);
+    }
+
+    if (ferror(file))
+        ret = -1;
+    if (fclose(file) != 0)
+        ret = -1;
+
+    free(bucket_start);
+    free(sorted);
+    free(entries);
+    return ret;
+}
+
+/*
+ * Mapeaza read-only un snapshot salvat cu ht_save_snapshot. hash_function si
+ * compare_function trebuie sa fie cele cu care a fost creat hashtable-ul
+ * salvat. Costul nu depinde de marimea tabelei: se valideaza doar header-ul
+ * (inclusiv ca bucket_start si entries incap in fisier); offset-urile din
+ * intrari se verifica la fiecare ht_snapshot_get. Intoarce NULL daca fisierul
+ * nu poate fi deschis sau nu e un snapshot valid.
+ */
+ht_snapshot_t *ht_snapshot_open(const char *path,
+		unsigned int (*hash_function)(void*),
+		int (*compare_function)(void*, void*))
+{
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+
+    if (fd < 0)
+        return NULL;
+
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(ht_snapshot_header_t)) {
+        close(fd);
+        return NULL;
+    }
+
+    void *base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    /* Maparea ramane valida si dupa inchiderea descriptorului. */
+    close(fd);
+    if (base == MAP_FAILED)
+        return NULL;
+
+    const ht_snapshot_header_t *header = base;
+    const uint64_t file_size = st.st_size;
+    const uint64_t table_end = sizeof(*header) +
+                               ((uint64_t)header->nbuckets + 1) * sizeof(uint32_t);
+    if (memcmp(header->magic, HT_SNAPSHOT_MAGIC, sizeof(header->magic)) != 0 ||
+        header->endian != HT_SNAPSHOT_ENDIAN ||
+        header->file_size != file_size ||
+        header->nbuckets == 0 ||
+        header->entries_off % 8 != 0 ||
+        table_end > header->entries_off || header->entries_off > file_size ||
+        header->size > (file_size - header->entries_off) /
+                       sizeof(ht_snapshot_entry_t) ||
+        ((const uint32_t *)((const char *)base + sizeof(*header)))
+            [header->nbuckets] != header->size) {
+        munmap(base, st.st_size);
+        return NULL;
+    }
+
+    ht_snapshot_t *snap = calloc(1, sizeof(ht_snapshot_t));
+    snap->base = base;
+    snap->length = st.st_size;
+    snap->header = header;
+    snap->bucket_start = (const uint32_t *)(snap->base + sizeof(*header));
+    snap->entries = (const ht_snapshot_entry_t *)(snap->base +
+                                                  header->entries_off);
+    snap->cfg.hash_function = hash_function;
+    snap->cfg.compare_function = compare_function;
+    snap->cfg.seed = header->seed;
+    snap->cfg.key_len = header->key_len;
+
+    return snap;
+}
+
+/*
+ * La fel ca ht_snapshot_open, pentru tabele create cu ht_create_seeded. Seed-ul
+ * si key_len se citesc din snapshot.
+ */
+ht_snapshot_t *ht_snapshot_open_seeded(const char *path,
+		uint64_t (*hash_function_len)(const void*, size_t, uint64_t),
+		int (*compare_function)(void*, void*))
+{
+    ht_snapshot_t *snap = ht_snapshot_open(path, NULL, compare_function);
+
+    if (snap != NULL)
+        snap->cfg.hash_function_len = hash_function_len;
+
+    return snap;
+}
+
+/*
+ * Verifica daca [off, off + size) e in interiorul maparii.
+ */
+static inline int ht_snapshot_in_bounds(ht_snapshot_t *snap, uint64_t off,
+	uint64_t size)
+{
+    return off <= snap->length && size <= snap->length - off;
+}
+
+/*
+ * Intoarce un pointer (read-only) spre valoarea asociata cheii key, direct in
+ * maparea fisierului, sau NULL daca cheia nu exista. Intervalele de bucket si
+ * intrarile care ar iesi din fisier (snapshot corupt) sunt ignorate.
+ */
+const void *ht_snapshot_get(ht_snapshot_t *snap, void *key)
+{
+    unsigned int hash = ht_hash(&snap->cfg, key);
+    unsigned int b = hash % snap->header->nbuckets;
+    uint32_t end = snap->bucket_start[b + 1];
+
+    if (end > snap->header->size)
+        end = snap->header->size;
+
+    for (uint32_t i = snap->bucket_start[b]; i < end; ++i) {
+        const ht_snapshot_entry_t *entry = &snap->entries[i];
+        if (entry->hash != hash ||
+            !ht_snapshot_in_bounds(snap, entry->key_off, entry->key_size) ||
+            entry->key_size < snap->cfg.key_len ||
+            !ht_snapshot_in_bounds(snap, entry->value_off, entry->value_size))
+            continue;
+        if (ht_keys_equal(&snap->cfg, key, (void *)(snap->base + entry->key_off)))
+            return snap->base + entry->value_off;
+    }
+
+    return NULL;
+}
+
+int ht_snapshot_has_key(ht_snapshot_t *snap, void *key)
+{
+    return ht_snapshot_get(snap, key) != NULL;
+}
+
+unsigned int ht_snapshot_get_size(ht_snapshot_t *snap)
+{
+    if (snap == NULL)
+        return 0;
+
+    return snap->header->size;
+}
+
+void ht_snapshot_close(ht_snapshot_t *snap)
+{
+    if (snap == NULL)
+        return;
+
+    munmap((void *)snap->base, snap->length);
+    free(snap);
+}
+
+/*
+ * Generator de hashtable-uri specializate pe tipuri fixe de cheie si valoare.
+ *
+ * DEFINE_HASHTABLE(name, K, V, hash, eq) defineste tipul name_t si functiile
+ * name_create, name_put, name_get, name_remove, name_get_size si name_free.
+ * Cheile si valorile se tin prin valoare intr-un singur array de intrari
+ * (adresare deschisa, sondare liniara, stergere prin mutarea inapoi a
+ * intrarilor urmatoare), iar hash(K) si eq(K, K) sunt apelate direct, deci
+ * compilatorul le poate face inline. Nu exista void*, apeluri indirecte sau
+ * memcpy de key_size octeti. hash trebuie sa amestece bine toti bitii, pentru
+ * ca indexul se ia din bitii de jos.
+ */
+#define DEFINE_HASHTABLE(name, K, V, hash, eq)				\
+typedef struct name##_entry_t {						\
+	K key;								\
+	V value;							\
+	unsigned int hash; /* 0 inseamna slot liber. */			\
+} name##_entry_t;							\
+									\
+typedef struct name##_t {						\
+	name##_entry_t *slots;						\
+	unsigned int mask; /* Nr. de sloturi - 1 (putere a lui 2). */	\
+	unsigned int size;						\
+} name##_t;								\
+									\
+static inline unsigned int name##_hash(K key)				\
+{									\
+	unsigned int h = (hash)(key);					\
+	return h ? h : 1;						\
+}									\
+									\
+static name##_t *name##_create(unsigned int hmax)			\
+{									\
+	name##_t *t = malloc(sizeof(name##_t));				\
+	unsigned int cap = 8;						\
+									\
+	while (cap < hmax)						\
+		cap <<= 1;						\
+	t->slots = calloc(cap, sizeof(name##_entry_t));			\
+	t->mask = cap - 1;						\
+	t->size = 0;							\
+	return t;							\
+}									\
+									\
+static void name##_grow(name##_t *t)					\
+{									\
+	name##_entry_t *old = t->slots;					\
+	unsigned int old_cap = t->mask + 1;				\
+									\
+	t->slots = calloc(2 * old_cap, sizeof(name##_entry_t));		\
+	t->mask = 2 * old_cap - 1;					\
+	for (unsigned int i = 0; i < old_cap; ++i) {			\
+		if (old[i].hash == 0)					\
+			continue;					\
+		unsigned int j = old[i].hash & t->mask;			\
+		while (t->slots[j].hash != 0)				\
+			j = (j + 1) & t->mask;				\
+		t->slots[j] = old[i];					\
+	}								\
+	free(old);							\
+}									\
+									\
+static inline V *name##_get(name##_t *t, K key)				\
+{									\
+	unsigned int h = name##_hash(key);				\
+									\
+	for (unsigned int i = h & t->mask;; i = (i + 1) & t->mask) {	\
+		name##_entry_t *e = &t->slots[i];			\
+		if (e->hash == 0)					\
+			return NULL;					\
+		if (e->hash == h && (eq)(e->key, key))			\
+			return &e->value;				\
+	}								\
+}									\
+									\
+static inline void name##_put(name##_t *t, K key, V value)		\
+{									\
+	/* Factor de incarcare maxim 3/4. */				\
+	if (4 * (t->size + 1) > 3 * (t->mask + 1))			\
+		name##_grow(t);						\
+									\
+	unsigned int h = name##_hash(key);				\
+	unsigned int i = h & t->mask;					\
+									\
+	for (;; i = (i + 1) & t->mask) {				\
+		name##_entry_t *e = &t->slots[i];			\
+		if (e->hash == 0)					\
+			break;						\
+		if (e->hash == h && (eq)(e->key, key)) {		\
+			e->value = value;				\
+			return;						\
+		}							\
+	}								\
+									\
+	t->slots[i].key = key;						\
+	t->slots[i].value = value;					\
+	t->slots[i].hash = h;						\
+	t->size++;							\
+}									\
+									\
+static inline int name##_remove(name##_t *t, K key)			\
+{									\
+	unsigned int h = name##_hash(key);				\
+	unsigned int i = h & t->mask;					\
+									\
+	for (;; i = (i + 1) & t->mask) {				\
+		if (t->slots[i].hash == 0)				\
+			return 0;					\
+		if (t->slots[i].hash == h && (eq)(t->slots[i].key, key))	\
+			break;						\
+	}								\
+									\
+	/* Muta inapoi intrarile care nu sunt in slotul lor de baza. */	\
+	unsigned int j = i;						\
+	while (1) {							\
+		j = (j + 1) & t->mask;					\
+		if (t->slots[j].hash == 0)				\
+			break;						\
+		unsigned int home = t->slots[j].hash & t->mask;		\
+		if (((j - home) & t->mask) >= ((j - i) & t->mask)) {	\
+			t->slots[i] = t->slots[j];			\
+			i = j;						\
+		}							\
+	}								\
+	t->slots[i].hash = 0;						\
+	t->size--;							\
+	return 1;							\
+}									\
+									\
+static inline unsigned int name##_get_size(name##_t *t)			\
+{									\
+	return t->size;							\
+}									\
+									\
+static void name##_free(name##_t *t)					\
+{									\
+	free(t->slots);							\
+	free(t);							\
+}
+
+/*
+ * Cheie string de lungime fixa, tinuta prin valoare (completata cu '\0').
+ */
+#define HT_STR_KEY_LEN 16
+
+typedef struct ht_str_key_t ht_str_key_t;
+struct ht_str_key_t {
+	char s[HT_STR_KEY_LEN];
+};
+
+static inline unsigned int ht_int_hash_inline(int key)
+{
+	unsigned int x = key;
+
+	x = ((x >> 16u) ^ x) * 0x45d9f3b;
+	x = ((x >> 16u) ^ x) * 0x45d9f3b;
+	return (x >> 16u) ^ x;
+}
+
+static inline int ht_int_eq_inline(int a, int b)
+{
+	return a == b;
+}
+
+static inline unsigned int ht_str_key_hash(ht_str_key_t key)
+{
+	uint64_t h = hash_len_wyhash(key.s, HT_STR_KEY_LEN, 0);
+	return (unsigned int)(h ^ (h >> 32));
+}
+
+static inline int ht_str_key_eq(ht_str_key_t a, ht_str_key_t b)
+{
+	return memcmp(a.s, b.s, HT_STR_KEY_LEN) == 0;
+}
+
+DEFINE_HASHTABLE(ht_int_int, int, int, ht_int_hash_inline, ht_int_eq_inline)
+DEFINE_HASHTABLE(ht_str_int, ht_str_key_t, int, ht_str_key_hash, ht_str_key_eq)
+
+/*
+ * Compara functiile de hashing pe trei tipuri de chei: nume scurte, UUID-uri
+ * (16 octeti) si id-uri pe 64 de biti. Pentru fiecare se masoara timpul de
+ * hashing pe cheie si timpul unui ht_get intr-o tabela cu n chei.
+ */
+void bench_hash(unsigned int n)
+{
+    static const struct {
+        const char *name;
+        uint64_t (*fn)(const void*, size_t, uint64_t);
+    } hashers[] = {
+        {"djb2", hash_len_djb2},
+        {"wyhash", hash_len_wyhash},
+        {"xxh64", hash_len_xxh64},
+        {"u64", hash_len_u64},
+    };
+    static const char *sets[] = {"names", "uuids", "ids"};
+    const unsigned int key_lens[] = {0, 16, 8};
+    const unsigned int strides[] = {16, 16, 8};
+    const unsigned int rounds = 10;
+    unsigned char *keys = malloc((size_t)n * 16);
+    uint64_t sink = 0;
+
+    srand(42);
+    for (unsigned int set = 0; set < 3; ++set) {
+        unsigned int stride = strides[set];
+
+        for (unsigned int i = 0; i < n; ++i) {
+            unsigned char *k = keys + (size_t)i * stride;
+            if (set == 0) {
+                snprintf((char *)k, 16, "%.*s%u", 1 + rand() % 6, "friend",
+                         (unsigned int)rand() % 1000000);
+            } else {
+                for (unsigned int b = 0; b < stride; ++b)
+                    k[b] = rand() & 0xff;
+            }
+        }
+
+        for (unsigned int h = 0; h < sizeof(hashers) / sizeof(hashers[0]); ++h) {
+            if (hashers[h].fn == hash_len_u64 && key_lens[set] != 8)
+                continue;
+
+            double start = now_sec();
+            for (unsigned int r = 0; r < rounds; ++r) {
+                for (unsigned int i = 0; i < n; ++i) {
+                    unsigned char *k = keys + (size_t)i * stride;
+                    size_t len = key_lens[set] ? key_lens[set] :
+                                 strlen((char *)k);
+                    sink ^= hashers[h].fn(k, len, r);
+                }
+            }
+            double hash_ns = (now_sec() - start) * 1e9 / ((double)n * rounds);
+
+            hashtable_t *ht = ht_create_seeded(HMAX, hashers[h].fn, 0x1234,
+                key_lens[set], set == 0 ? compare_function_strings : NULL,
+                key_val_free_function);
+            for (unsigned int i = 0; i < n; ++i) {
+                unsigned char *k = keys + (size_t)i * stride;
+                unsigned int key_size = key_lens[set] ? key_lens[set] :
+                                        strlen((char *)k) + 1;
+                ht_put(ht, k, key_size, &i, sizeof(i));
+            }
+
+            start = now_sec();
+            for (unsigned int r = 0; r < rounds; ++r) {
+                for (unsigned int i = 0; i < n; ++i)
+                    sink ^= (uintptr_t)ht_get(ht, keys + (size_t)i * stride);
+            }
+            double get_ns = (now_sec() - start) * 1e9 / ((double)n * rounds);
+
+            printf("%-6s %-7s hash: %6.2f ns/key | get: %7.2f ns/op\n",
+                   sets[set], hashers[h].name, hash_ns, get_ns);
+            ht_free(ht);
+        }
+    }
+
+    free(keys);
+    if (sink == 42)
+        printf("\n");
+}
+
+/*
+ * Compara n apeluri ht_get cu un singur ht_get_many pe aceleasi n chei
+ * aleatoare, intr-o tabela cu n chei int (deci mult mai mare decat cache-ul
+ * pentru n de ordinul milioanelor). Timpii sunt medii pe mai multe ture.
+ */
+void bench_batch(unsigned int n)
+{
+    hashtable_t *ht = ht_create(HMAX, hash_function_int, compare_function_ints,
+                                key_val_free_function);
+    int *ids = malloc(n * sizeof(int));
+    void **keys = malloc(n * sizeof(void*));
+    void **values = malloc(n * sizeof(void*));
+    unsigned int *key_sizes = malloc(n * sizeof(unsigned int));
+    uintptr_t sink = 0;
+
+    for (unsigned int i = 0; i < n; ++i) {
+        ids[i] = i;
+        keys[i] = &ids[i];
+        key_sizes[i] = sizeof(int);
+    }
+
+    double start = now_sec();
+    ht_put_many(ht, keys, key_sizes, keys, key_sizes, n);
+    double put_ns = (now_sec() - start) * 1e9 / n;
+
+    srand(7);
+    for (unsigned int i = 0; i < n; ++i)
+        keys[i] = &ids[rand() % n];
+
+    /*
+     * O tura de incalzire, nemasurata, apoi ture in care ordinea celor doua
+     * variante se alterneaza, ca niciuna sa nu profite mereu de cache-urile
+     * si predictorii deja incalziti de cealalta.
+     */
+    const unsigned int rounds = 4;
+    double single_sec = 0, batch_sec = 0;
+
+    for (unsigned int r = 0; r <= rounds; ++r) {
+        for (unsigned int pass = 0; pass < 2; ++pass) {
+            int batched = (pass + r) & 1;
+
+            start = now_sec();
+            if (batched) {
+                ht_get_many(ht, keys, n, values);
+            } else {
+                for (unsigned int i = 0; i < n; ++i)
+                    sink ^= (uintptr_t)ht_get(ht, keys[i]);
+            }
+            double elapsed = now_sec() - start;
+
+            if (r == 0)
+                continue;
+            if (batched)
+                batch_sec += elapsed;
+            else
+                single_sec += elapsed;
+        }
+        for (unsigned int i = 0; i < n; ++i)
+            sink ^= (uintptr_t)values[i];
+    }
+    double single_ns = single_sec * 1e9 / ((double)n * rounds);
+    double batch_ns = batch_sec * 1e9 / ((double)n * rounds);
+
+    printf("put_many: %.2f ns/key | get: %.2f ns/key | get_many: %.2f ns/key "
+           "| speedup: %.2fx\n", put_ns, single_ns, batch_ns,
+           batch_ns > 0 ? single_ns / batch_ns : 0.0);
+
+    ht_free(ht);
+    free(key_sizes);
+    free(values);
+    free(keys);
+    free(ids);
+    if (sink == 42)
+        printf("\n");
+}
+
+/*
+ * Masoara cat dureaza ht_free pe o tabela cu n intrari (chei int, valori
+ * FriendInfo), cu malloc obisnuit si in modul arena.
+ */
+void bench_teardown(unsigned int n)
+{
+    struct { char name[64]; int age; } value = {"friend", 20};
+
+    for (int arena = 0; arena < 2; ++arena) {
+        hashtable_t *ht = ht_create(HMAX, hash_function_int,
+                                    compare_function_ints,
+                                    key_val_free_function);
+        if (arena)
+            ht_enable_arena(ht);
+
+        double start = now_sec();
+        for (unsigned int i = 0; i < n; ++i)
+            ht_put(ht, &i, sizeof(i), &value, sizeof(value));
+        double build = now_sec() - start;
+
+        start = now_sec();
+        ht_free(ht);
+        double teardown = now_sec() - start;
+
+        printf("%-6s build: %8.2f ms | ht_free: %8.2f ms\n",
+               arena ? "arena" : "malloc", build * 1e3, teardown * 1e3);
+    }
+}
+
+/*
+ * Compara hashtable_t generic cu tabelele generate de DEFINE_HASHTABLE, pe n
+ * chei int si pe n chei string de HT_STR_KEY_LEN octeti: put pentru toate
+ * cheile, apoi get in ordine aleatoare.
+ */
+void bench_specialized(unsigned int n)
+{
+    ht_str_key_t *names = calloc(n, sizeof(ht_str_key_t));
+    unsigned int *order = malloc(n * sizeof(unsigned int));
+    long sink = 0;
+
+    srand(11);
+    for (unsigned int i = 0; i < n; ++i) {
+        snprintf(names[i].s, HT_STR_KEY_LEN, "friend%08x", i);
+        order[i] = rand() % n;
+    }
+
+    for (int strings = 0; strings < 2; ++strings) {
+        hashtable_t *ht = strings ?
+            ht_create(HMAX, hash_function_string, compare_function_strings,
+                      key_val_free_function) :
+            ht_create(HMAX, hash_function_int, compare_function_ints,
+                      key_val_free_function);
+
+        double start = now_sec();
+        for (unsigned int i = 0; i < n; ++i) {
+            if (strings)
+                ht_put(ht, names[i].s, HT_STR_KEY_LEN, &i, sizeof(i));
+            else
+                ht_put(ht, &i, sizeof(i), &i, sizeof(i));
+        }
+        double put_generic = now_sec() - start;
+
+        start = now_sec();
+        for (unsigned int i = 0; i < n; ++i) {
+            int *v = strings ? ht_get(ht, names[order[i]].s) :
+                               ht_get(ht, &order[i]);
+            sink += *v;
+        }
+        double get_generic = now_sec() - start;
+        ht_free(ht);
+
+        double put_special, get_special;
+        if (strings) {
+            ht_str_int_t *t = ht_str_int_create(HMAX);
+
+            start = now_sec();
+            for (unsigned int i = 0; i < n; ++i)
+                ht_str_int_put(t, names[i], i);
+            put_special = now_sec() - start;
+
+            start = now_sec();
+            for (unsigned int i = 0; i < n; ++i)
+                sink += *ht_str_int_get(t, names[order[i]]);
+            get_special = now_sec() - start;
+            ht_str_int_free(t);
+        } else {
+            ht_int_int_t *t = ht_int_int_create(HMAX);
+
+            start = now_sec();
+            for (unsigned int i = 0; i < n; ++i)
+                ht_int_int_put(t, i, i);
+            put_special = now_sec() - start;
+
+            start = now_sec();
+            for (unsigned int i = 0; i < n; ++i)
+                sink += *ht_int_int_get(t, order[i]);
+            get_special = now_sec() - start;
+            ht_int_int_free(t);
+        }
+
+        printf("%-7s generic put: %6.2f ns get: %6.2f ns | "
+               "specialized put: %6.2f ns get: %6.2f ns\n",
+               strings ? "str16" : "int", put_generic * 1e9 / n,
+               get_generic * 1e9 / n, put_special * 1e9 / n,
+               get_special * 1e9 / n);
+    }
+
+    free(order);
+    free(names);
+    if (sink == 42)
+        printf("\n");
+}
+
+static int compare_doubles(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+
+    return (x > y) - (x < y);
+}
+
+/*
+ * Sorteaza latentele si afiseaza p50, p99, p99.9 si maximul, in ns.
+ */
+static void print_percentiles(const char *what, double *lat, unsigned int n)
+{
+    qsort(lat, n, sizeof(double), compare_doubles);
+    printf("%-4s p50: %7.0f ns | p99: %7.0f ns | p999: %7.0f ns | "
+           "max: %9.0f ns\n", what, lat[n / 2] * 1e9,
+           lat[(unsigned long)n * 99 / 100] * 1e9,
+           lat[(unsigned long)n * 999 / 1000] * 1e9, lat[n - 1] * 1e9);
+}
+
+/*
+ * Masoara separat fiecare ht_put si fiecare ht_get intr-o tabela cu n chei int
+ * (pornind de la HMAX) si afiseaza distributia latentelor. Aceeasi comanda
+ * exista in hash-table.c si in cuckoo.c, ca sa putem compara cozile.
+ */
+void bench_latency(unsigned int n)
+{
+    hashtable_t *ht = ht_create(HMAX, hash_function_int, compare_function_ints,
+                                key_val_free_function);
+    double *lat = malloc(n * sizeof(double));
+    long sink = 0;
+
+    for (unsigned int i = 0; i < n; ++i) {
+        double start = now_sec();
+        ht_put(ht, &i, sizeof(i), &i, sizeof(i));
+        lat[i] = now_sec() - start;
+    }
+    print_percentiles("put", lat, n);
+
+    srand(13);
+    for (unsigned int i = 0; i < n; ++i) {
+        unsigned int key = rand() % n;
+        double start = now_sec();
+        int *value = ht_get(ht, &key);
+        lat[i] = now_sec() - start;
+        sink += *value;
+    }
+    print_percentiles("get", lat, n);
+
+    ht_free(ht);
+    free(lat);
+    if (sink == 42)
+        printf("\n");
+}
+
+struct FriendInfo {
+	char name[MAX_STRING_SIZE];
+	char faculty[MAX_STRING_SIZE];
+	char fav_food[MAX_STRING_SIZE];
+	int age;
+};
+
+static void print_friend(struct FriendInfo *f_info)
+{
+	if (f_info == NULL) {
 		printf("Friend doesn't exist!\n");
 		return;
 	}
@@ -515,16 +2842,299 @@ static void print_friend(struct FriendInfo *f_info)
 	printf("Favorite food: %s\n", f_info->fav_food);
 }
 
+/*
+ * Compara memoria (masurata cu mallinfo2) ocupata de n prieteni in forma
+ * actuala (cheie nume copiat, valoare FriendInfo cu trei array-uri) si in forma
+ * internata (cheie handle, valoare cu trei handle-uri si varsta), cu nume din
+ * n / 4 distincte si facultati / mancaruri din cateva zeci.
+ */
+void bench_intern(unsigned int n)
+{
+    struct FriendInfo info_f;
+    struct { const char *name, *faculty, *fav_food; int age; } record;
+    unsigned int distinct = n / 4 ? n / 4 : 1;
+
+    for (int interned = 0; interned < 2; ++interned) {
+        size_t before = mallinfo2().uordblks;
+        double start = now_sec();
+        ht_intern_pool_t *pool = interned ? ht_intern_create() : NULL;
+        hashtable_t *ht = interned ?
+            ht_create(HMAX, hash_function_interned, compare_function_interned,
+                      key_val_free_function) :
+            ht_create(HMAX, hash_function_string, compare_function_strings,
+                      key_val_free_function);
+
+        for (unsigned int i = 0; i < n; ++i) {
+            snprintf(info_f.name, sizeof(info_f.name), "friend%u",
+                     i % distinct);
+            snprintf(info_f.faculty, sizeof(info_f.faculty), "faculty%u",
+                     i % 17);
+            snprintf(info_f.fav_food, sizeof(info_f.fav_food), "food%u",
+                     i % 43);
+            info_f.age = 18 + i % 10;
+
+            if (!interned) {
+                ht_put(ht, info_f.name, strlen(info_f.name) + 1, &info_f,
+                       sizeof(info_f));
+                continue;
+            }
+
+            record.name = ht_intern(pool, info_f.name);
+            record.faculty = ht_intern(pool, info_f.faculty);
+            record.fav_food = ht_intern(pool, info_f.fav_food);
+            record.age = info_f.age;
+            ht_put(ht, &record.name, sizeof(record.name), &record,
+                   sizeof(record));
+        }
+
+        double build = now_sec() - start;
+        size_t used = mallinfo2().uordblks - before;
+
+        printf("%-8s entries: %u | strings: %u | memory: %8.2f KiB | "
+               "build: %.2f ms\n", interned ? "interned" : "copied",
+               ht_get_size(ht), ht_intern_count(pool), used / 1024.0,
+               build * 1e3);
+
+        ht_free(ht);
+        ht_intern_free(pool);
+    }
+}
+
+/*
+ * Verifica iteratorul cand se sterg alte intrari decat cea curenta in timpul
+ * parcurgerii (inclusiv nodul pe care iteratorul l-a retinut ca urmator):
+ * intai cu ht_remove_entry, apoi prin evacuari in modul cache
+ * (fiecare put al unei chei noi evacueaza o intrare veche). O intrare trebuie
+ * intoarsa cel mult o data, niciodata dupa ce a fost stearsa, iar cele
+ * nesterse exact o data.
+ */
+void check_iter(unsigned int n)
+{
+    unsigned char *seen = calloc(n ? n : 1, 1);
+    unsigned char *removed = calloc(n ? n : 1, 1);
+    ht_iterator_t it;
+    info *information;
+    unsigned int step = 0;
+    int ok = 1;
+
+    hashtable_t *ht = ht_create(HMAX, hash_function_int, compare_function_ints,
+                                key_val_free_function);
+    for (unsigned int i = 0; i < n; ++i)
+        ht_put(ht, &i, sizeof(i), &i, sizeof(i));
+
+    ht_iter_init(ht, &it);
+    while ((information = ht_iter_next(&it)) != NULL) {
+        unsigned int key = *(unsigned int *)information->key;
+
+        if (removed[key] || seen[key]++)
+            ok = 0;
+
+        /*
+         * Din doi in doi pasi se sterge chiar nodul retinut de iterator ca
+         * urmator, iar la ceilalti o intrare oarecare inca nevizitata.
+         */
+        unsigned int other = (key * 7 + 3) % n;
+        if ((step++ & 1) == 0 && it.next != NULL && it.next->data != NULL)
+            other = *(unsigned int *)((info *)it.next->data)->key;
+        if (other != key && !seen[other] && !removed[other]) {
+            ht_remove_entry(ht, &other);
+            removed[other] = 1;
+        }
+    }
+    ht_iter_release(&it);
+
+    for (unsigned int i = 0; i < n; ++i) {
+        if (!removed[i] && seen[i] != 1)
+            ok = 0;
+    }
+    ht_free(ht);
+
+    ht = ht_create(HMAX, hash_function_int, compare_function_ints,
+                   key_val_free_function);
+    ht_set_capacity(ht, n);
+    for (unsigned int i = 0; i < n; ++i)
+        ht_put(ht, &i, sizeof(i), &i, sizeof(i));
+
+    memset(seen, 0, n);
+    unsigned int fresh = n;
+    ht_iter_init(ht, &it);
+    while ((information = ht_iter_next(&it)) != NULL) {
+        unsigned int key = *(unsigned int *)information->key;
+
+        if (key < n && seen[key]++)
+            ok = 0;
+        if (!ht_has_key(ht, &key))
+            ok = 0;
+
+        ht_put(ht, &fresh, sizeof(fresh), &fresh, sizeof(fresh));
+        fresh++;
+    }
+    ht_iter_release(&it);
+    if (ht_get_size(ht) > n)
+        ok = 0;
+    ht_free(ht);
+
+    printf("check_iter: %s\n", ok ? "ok" : "FAILED");
+    free(removed);
+    free(seen);
+}
+
+/*
+ * Verifica ht_export_sorted pe o tabela seeded cu chei string si fara
+ * comparator (key_len == 0): perechile trebuie sa iasa in ordinea lui strcmp.
+ */
+void check_export(unsigned int n)
+{
+    hashtable_t *ht = ht_create_seeded(HMAX, hash_len_wyhash, 0x1234, 0, NULL,
+                                       key_val_free_function);
+    ht_pair_t *pairs = malloc((n ? n : 1) * sizeof(ht_pair_t));
+    char key[32];
+    int ok = 1;
+
+    srand(11);
+    for (unsigned int i = 0; i < n; ++i) {
+        snprintf(key, sizeof(key), "friend%u", (unsigned int)rand());
+        ht_put(ht, key, strlen(key) + 1, &i, sizeof(i));
+    }
+
+    unsigned int count = ht_export_sorted(ht, pairs, ht_get_size(ht));
+    if (count != ht_get_size(ht))
+        ok = 0;
+    for (unsigned int i = 1; i < count; ++i) {
+        if (strcmp(pairs[i - 1].key, pairs[i].key) >= 0)
+            ok = 0;
+    }
+
+    printf("check_export: %s\n", ok ? "ok" : "FAILED");
+    free(pairs);
+    ht_free(ht);
+}
+
+/*
+ * Incarcare rapida a unui jurnal de comenzi "add_friend nume varsta facultate
+ * mancare" (alte comenzi sunt ignorate). Fisierul se mapeaza in memorie si se
+ * parcurge o singura data, fara scanf; tabela se dimensioneaza dupa count_hint
+ * (sau, daca e 0, dupa nr. de linii), iar prietenii se insereaza in loturi de
+ * HT_LOAD_BATCH cu ht_put_many. Intoarce nr. de prieteni cititi sau -1.
+ */
+#define HT_LOAD_BATCH 256
+
+static const char *skip_blanks(const char *p, const char *end)
+{
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+        p++;
+    return p;
+}
+
+/*
+ * Copiaza urmatorul cuvant de pe linie in dst (trunchiat la size - 1) si
+ * intoarce pozitia de dupa el.
+ */
+static const char *next_token(const char *p, const char *end, char *dst,
+	size_t size)
+{
+    const char *start = p = skip_blanks(p, end);
+
+    while (p < end && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n')
+        p++;
+
+    size_t len = (size_t)(p - start) < size - 1 ? (size_t)(p - start) : size - 1;
+    memcpy(dst, start, len);
+    dst[len] = '\0';
+    return p;
+}
+
+long ht_load_friends(hashtable_t *ht, const char *path, unsigned int count_hint)
+{
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+
+    if (fd < 0)
+        return -1;
+
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        return -1;
+    }
+    if (st.st_size == 0) {
+        close(fd);
+        return 0;
+    }
+
+    const char *base = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+        return -1;
+    madvise((void *)base, st.st_size, MADV_SEQUENTIAL);
+
+    const char *p = base, *end = base + st.st_size;
+
+    if (count_hint == 0) {
+        for (const char *q = p; (q = memchr(q, '\n', end - q)) != NULL; ++q)
+            count_hint++;
+        /* Ultima linie poate sa nu se termine cu '\n'. */
+        if (end[-1] != '\n')
+            count_hint++;
+    }
+    ht_reserve(ht, ht_get_size(ht) + count_hint);
+
+    struct FriendInfo *batch = malloc(HT_LOAD_BATCH * sizeof(struct FriendInfo));
+    void *keys[HT_LOAD_BATCH], *values[HT_LOAD_BATCH];
+    unsigned int key_sizes[HT_LOAD_BATCH], value_sizes[HT_LOAD_BATCH];
+    unsigned int n = 0;
+    long loaded = 0;
+
+    while (p < end) {
+        char command[MAX_STRING_SIZE];
+
+        p = next_token(p, end, command, sizeof(command));
+        if (strcmp(command, "add_friend") == 0) {
+            struct FriendInfo *f = &batch[n];
+            char age[16];
+
+            p = next_token(p, end, f->name, sizeof(f->name));
+            p = next_token(p, end, age, sizeof(age));
+            p = next_token(p, end, f->faculty, sizeof(f->faculty));
+            p = next_token(p, end, f->fav_food, sizeof(f->fav_food));
+            f->age = atoi(age);
+
+            keys[n] = f->name;
+            key_sizes[n] = strlen(f->name) + 1;
+            values[n] = f;
+            value_sizes[n] = sizeof(*f);
+            if (++n == HT_LOAD_BATCH) {
+                ht_put_many(ht, keys, key_sizes, values, value_sizes, n);
+                loaded += n;
+                n = 0;
+            }
+        }
+
+        /* Restul liniei (sau linia unei alte comenzi) se sare. */
+        const char *eol = memchr(p, '\n', end - p);
+        p = eol ? eol + 1 : end;
+    }
+
+    ht_put_many(ht, keys, key_sizes, values, value_sizes, n);
+    loaded += n;
+
+    free(batch);
+    munmap((void *)base, st.st_size);
+    return loaded;
+}
+
 int main()
 {
 	hashtable_t *ht_friends = NULL;
+	/* Daca nu exista hashtable, print/check_friend cauta in snapshot. */
+	ht_snapshot_t *snap_friends = NULL;
 	struct FriendInfo info_f;
 	struct FriendInfo *p_infoFriend;
 
 	while (1) {
 		char command[MAX_STRING_SIZE];
 
-		scanf("%s", command);
+		if (scanf("%s", command) != 1)
+			break;
 		if (strncmp(command, "create_ht", 9) == 0) {
 			ht_friends = ht_create(HMAX, hash_function_string,
 				compare_function_strings, key_val_free_function);
@@ -545,7 +3155,10 @@ int main()
 
 			scanf("%s", name);
 
-			if (!ht_friends) {
+			if (!ht_friends && snap_friends) {
+				print_friend((struct FriendInfo *)ht_snapshot_get(snap_friends,
+					name));
+			} else if (!ht_friends) {
 				printf("Create hashtable first.\n");
 			} else {
 				p_infoFriend = ht_get(ht_friends, name);
@@ -556,7 +3169,10 @@ int main()
 			char name[MAX_STRING_SIZE];
 
 			scanf("%s", name);
-			if (!ht_friends) {
+			if (!ht_friends && snap_friends) {
+				printf(ht_snapshot_has_key(snap_friends, name) ?
+					"Friend %s exists.\n" : "Friend %s doesn't exist.\n", name);
+			} else if (!ht_friends) {
 				printf("Create hashtable first.\n");
 			} else if(ht_has_key(ht_friends, name)) {
 				printf("Friend %s exists.\n", name);
@@ -574,12 +3190,146 @@ int main()
 				ht_remove_entry(ht_friends, name);
 			}
 
-		} else if (strncmp(command, "free", 4) == 0) {
+		} else if (strncmp(command, "print_all", 9) == 0) {
+			if (!ht_friends) {
+				printf("Create hashtable first.\n");
+			} else {
+				unsigned int n = ht_get_size(ht_friends);
+				ht_pair_t *pairs = malloc((n ? n : 1) * sizeof(ht_pair_t));
+
+				n = ht_export_sorted(ht_friends, pairs, n);
+				for (unsigned int i = 0; i < n; ++i)
+					print_friend(pairs[i].value);
+				free(pairs);
+			}
+
+		} else if (strncmp(command, "print_stats", 11) == 0) {
+			if (!ht_friends) {
+				printf("Create hashtable first.\n");
+			} else {
+				ht_print_stats(ht_friends);
+			}
+
+		} else if (strncmp(command, "enable_bloom", 12) == 0) {
+			unsigned int expected;
+
+			scanf("%u", &expected);
+			if (!ht_friends) {
+				printf("Create hashtable first.\n");
+			} else {
+				ht_enable_bloom(ht_friends, expected);
+			}
+
+		} else if (strncmp(command, "set_capacity", 12) == 0) {
+			unsigned int capacity;
+
+			scanf("%u", &capacity);
+			if (!ht_friends) {
+				printf("Create hashtable first.\n");
+			} else {
+				ht_set_capacity(ht_friends, capacity);
+			}
+
+		} else if (strncmp(command, "put_stats", 9) == 0) {
+			if (!ht_friends) {
+				printf("Create hashtable first.\n");
+			} else {
+				ht_print_put_stats(ht_friends);
+			}
+
+		} else if (strncmp(command, "bench_hash", 10) == 0) {
+			unsigned int n;
+
+			scanf("%u", &n);
+			bench_hash(n);
+
+		} else if (strncmp(command, "bench_batch", 11) == 0) {
+			unsigned int n;
+
+			scanf("%u", &n);
+			bench_batch(n);
+
+		} else if (strncmp(command, "bench_teardown", 14) == 0) {
+			unsigned int n;
+
+			scanf("%u", &n);
+			bench_teardown(n);
+
+		} else if (strncmp(command, "bench_specialized", 17) == 0) {
+			unsigned int n;
+
+			scanf("%u", &n);
+			bench_specialized(n);
+
+		} else if (strncmp(command, "bench_latency", 13) == 0) {
+			unsigned int n;
+
+			scanf("%u", &n);
+			bench_latency(n);
+
+		} else if (strncmp(command, "bench_intern", 12) == 0) {
+			unsigned int n;
+
+			scanf("%u", &n);
+			bench_intern(n);
+
+		} else if (strncmp(command, "check_iter", 10) == 0) {
+			unsigned int n;
+
+			scanf("%u", &n);
+			check_iter(n);
+
+		} else if (strncmp(command, "check_export", 12) == 0) {
+			unsigned int n;
+
+			scanf("%u", &n);
+			check_export(n);
+
+		} else if (strncmp(command, "load_friends", 12) == 0) {
+			char path[MAX_STRING_SIZE];
+			unsigned int count_hint;
+
+			scanf("%s %u", path, &count_hint);
 			if (!ht_friends) {
 				printf("Create hashtable first.\n");
 			} else {
+				double start = now_sec();
+				long loaded = ht_load_friends(ht_friends, path, count_hint);
+
+				if (loaded < 0)
+					printf("Cannot load %s\n", path);
+				else
+					printf("Loaded %ld friends in %.2f ms\n", loaded,
+					       (now_sec() - start) * 1e3);
+			}
+
+		} else if (strncmp(command, "save_snapshot", 13) == 0) {
+			char path[MAX_STRING_SIZE];
+
+			scanf("%s", path);
+			if (!ht_friends) {
+				printf("Create hashtable first.\n");
+			} else if (ht_save_snapshot(ht_friends, path) != 0) {
+				printf("Could not save snapshot %s.\n", path);
+			}
+
+		} else if (strncmp(command, "load_snapshot", 13) == 0) {
+			char path[MAX_STRING_SIZE];
+
+			scanf("%s", path);
+			ht_snapshot_close(snap_friends);
+			snap_friends = ht_snapshot_open(path, hash_function_string,
+				compare_function_strings);
+			if (!snap_friends)
+				printf("Could not load snapshot %s.\n", path);
+
+		} else if (strncmp(command, "free", 4) == 0) {
+			if (!ht_friends && !snap_friends) {
+				printf("Create hashtable first.\n");
+			} else if (ht_friends) {
 				ht_free(ht_friends);
 			}
+			ht_snapshot_close(snap_friends);
 			break;
 		}
 	}
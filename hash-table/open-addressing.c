@@ -0,0 +1,463 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_STRING_SIZE	256
+#define HMAX 10
+
+/*
+ * Varianta cu adresare deschisa (Robin Hood) a hashtable-ului din
+ * hash-table.c. Interfata (ht_create/ht_put/ht_get/ht_has_key/ht_remove_entry/
+ * ht_free) este aceeasi, dar in loc de un array de liste inlantuite avem un
+ * singur array de sloturi. Fiecare slot retine hash-ul complet al cheii,
+ * distanta fata de bucket-ul "acasa" si pointerii spre cheie/valoare, deci o
+ * cautare parcurge sloturi consecutive din memorie in loc sa sara din nod in
+ * nod. Cheia si valoarea nu stau in slot: ht_put le copiaza intr-un bloc
+ * alocat separat (un malloc per intrare), asa ca fiecare comparare de chei
+ * face un salt in afara array-ului. Hash-ul pastrat in slot se compara
+ * inainte, deci saltul se face practic doar pentru cheia cautata.
+ */
+
+/* Factorul de incarcare maxim, exprimat ca fractie: 4/5. */
+#define HT_LOAD_NUM 4
+#define HT_LOAD_DEN 5
+/* Nr. maxim de sloturi: hmax e unsigned int si trebuie sa ramana putere a lui 2. */
+#define HT_MAX_SLOTS (1u << 31)
+
+typedef struct info info;
+struct info {
+	void *key;
+	void *value;
+};
+
+typedef struct ht_slot_t ht_slot_t;
+struct ht_slot_t {
+	/* Hash-ul complet al cheii, pastrat ca sa nu mai apelam hash_function. */
+	unsigned int hash;
+	/* Distanta fata de bucket-ul initial + 1; 0 inseamna slot liber. */
+	unsigned int dist;
+	info entry;
+};
+
+typedef struct hashtable_t hashtable_t;
+struct hashtable_t {
+	ht_slot_t *slots; /* Array-ul de sloturi (putere a lui 2). */
+	/* Nr. total de intrari existente curent in tabela. */
+	unsigned int size;
+	unsigned int hmax; /* Nr. de sloturi. */
+	unsigned int shift; /* 32 - log2(hmax), pentru hashing Fibonacci. */
+	/* (Pointer la) Functie pentru a calcula valoarea hash asociata cheilor. */
+	unsigned int (*hash_function)(void*);
+	/* (Pointer la) Functie pentru a compara doua chei. */
+	int (*compare_function)(void*, void*);
+	/* (Pointer la) Functie pentru a elibera memoria ocupata de cheie si valoare. */
+	void (*key_val_free_function)(void*);
+};
+
+/*
+ * Functii de comparare a cheilor:
+ */
+int compare_function_ints(void *a, void *b)
+{
+	int int_a = *((int *)a);
+	int int_b = *((int *)b);
+
+	if (int_a == int_b) {
+		return 0;
+	} else if (int_a < int_b) {
+		return -1;
+	} else {
+		return 1;
+	}
+}
+
+int compare_function_strings(void *a, void *b)
+{
+	char *str_a = (char *)a;
+	char *str_b = (char *)b;
+
+	return strcmp(str_a, str_b);
+}
+
+/*
+ * Functii de hashing:
+ */
+unsigned int hash_function_int(void *a)
+{
+	/*
+	 * Credits: https://stackoverflow.com/a/12996028/7883884
+	 */
+	unsigned int uint_a = *((unsigned int *)a);
+
+	uint_a = ((uint_a >> 16u) ^ uint_a) * 0x45d9f3b;
+	uint_a = ((uint_a >> 16u) ^ uint_a) * 0x45d9f3b;
+	uint_a = (uint_a >> 16u) ^ uint_a;
+	return uint_a;
+}
+
+unsigned int hash_function_string(void *a)
+{
+	/*
+	 * Credits: http://www.cse.yorku.ca/~oz/hash.html
+	 */
+	unsigned char *puchar_a = (unsigned char*) a;
+	unsigned long hash = 5381;
+	int c;
+
+	while ((c = *puchar_a++))
+		hash = ((hash << 5u) + hash) + c; /* hash * 33 + c */
+
+	return hash;
+}
+
+/*
+ * Functie apelata pentru a elibera memoria ocupata de cheia si valoarea unei
+ * intrari. Structura info traieste in slot, iar cheia si valoarea sunt alocate
+ * intr-un singur bloc care incepe cu cheia, deci e suficient un singur free.
+ */
+void key_val_free_function(void *data) {
+
+    if (!data)
+        return;
+    info *information = (info*) data;
+
+    free(information->key);
+    information->key = NULL;
+    information->value = NULL;
+}
+
+/*
+ * Bucket-ul "acasa" al unui hash. Folosim hashing Fibonacci (inmultire cu
+ * 2^32 / phi si bitii de sus) ca sa nu depindem de bitii de jos ai functiilor
+ * de hash slabe, cum e djb2 pe chei scurte.
+ */
+static unsigned int ht_home(hashtable_t *ht, unsigned int hash)
+{
+    return (unsigned int)(hash * 2654435769u) >> ht->shift;
+}
+
+/*
+ * Aloca cel putin hmax sloturi (dar cel mult HT_MAX_SLOTS). Intoarce 0 la
+ * succes si -1 daca alocarea esueaza; atunci tabela ramane neschimbata.
+ */
+static int ht_alloc_slots(hashtable_t *ht, unsigned int hmax)
+{
+    unsigned int cap = 8, shift = 29;
+
+    if (hmax > HT_MAX_SLOTS)
+        hmax = HT_MAX_SLOTS;
+
+    while (cap < hmax) {
+        cap <<= 1;
+        shift--;
+    }
+
+    ht_slot_t *slots = calloc(cap, sizeof(ht_slot_t));
+    if (slots == NULL)
+        return -1;
+
+    ht->slots = slots;
+    ht->hmax = cap;
+    ht->shift = shift;
+    return 0;
+}
+
+/*
+ * Insereaza un slot despre care stim ca nu exista deja in tabela, mutand
+ * intrarile "bogate" (mai aproape de casa) mai la dreapta.
+ */
+static void ht_insert_slot(hashtable_t *ht, ht_slot_t slot)
+{
+    unsigned int mask = ht->hmax - 1;
+    unsigned int pos = ht_home(ht, slot.hash);
+
+    slot.dist = 1;
+    while (ht->slots[pos].dist != 0) {
+        if (ht->slots[pos].dist < slot.dist) {
+            ht_slot_t tmp = ht->slots[pos];
+            ht->slots[pos] = slot;
+            slot = tmp;
+        }
+        pos = (pos + 1) & mask;
+        slot.dist++;
+    }
+    ht->slots[pos] = slot;
+}
+
+/*
+ * Dubleaza numarul de sloturi. Hash-urile sunt pastrate in sloturi, asa ca
+ * cheile nu se mai trec prin hash_function. Intoarce -1 (si lasa tabela cum
+ * era) daca e deja la HT_MAX_SLOTS sau alocarea esueaza.
+ */
+static int ht_grow(hashtable_t *ht)
+{
+    ht_slot_t *old = ht->slots;
+    unsigned int old_hmax = ht->hmax;
+
+    if (old_hmax >= HT_MAX_SLOTS || ht_alloc_slots(ht, old_hmax << 1) != 0)
+        return -1;
+
+    for (unsigned int i = 0; i < old_hmax; ++i) {
+        if (old[i].dist != 0)
+            ht_insert_slot(ht, old[i]);
+    }
+
+    free(old);
+    return 0;
+}
+
+/*
+ * Intoarce slotul care contine cheia key sau NULL daca nu exista.
+ */
+static ht_slot_t *ht_find_slot(hashtable_t *ht, void *key, unsigned int hash)
+{
+    unsigned int mask = ht->hmax - 1;
+    unsigned int pos = ht_home(ht, hash);
+    unsigned int dist = 1;
+
+    /* Daca intalnim o intrare mai aproape de casa decat noi, cheia lipseste. */
+    while (ht->slots[pos].dist >= dist) {
+        ht_slot_t *slot = &ht->slots[pos];
+        if (slot->hash == hash &&
+            ht->compare_function(key, slot->entry.key) == 0)
+            return slot;
+        pos = (pos + 1) & mask;
+        dist++;
+    }
+
+    return NULL;
+}
+
+/*
+ * Functie apelata dupa alocarea unui hashtable pentru a-l initializa.
+ * hmax este rotunjit in sus la o putere a lui 2 (cel mult HT_MAX_SLOTS).
+ * Intoarce NULL daca sloturile nu pot fi alocate.
+ */
+hashtable_t *ht_create(unsigned int hmax, unsigned int (*hash_function)(void*),
+		int (*compare_function)(void*, void*),
+		void (*key_val_free_function)(void*))
+{
+    hashtable_t *table = malloc(sizeof(hashtable_t));
+
+    if (table == NULL || ht_alloc_slots(table, hmax) != 0) {
+        free(table);
+        return NULL;
+    }
+    table->size = 0;
+
+    table->key_val_free_function = key_val_free_function;
+    table->hash_function = hash_function;
+    table->compare_function = compare_function;
+
+    return table;
+}
+
+/*
+ * Functie care intoarce:
+ * 1, daca pentru cheia key a fost asociata anterior o valoare in hashtable
+ * folosind functia put;
+ * 0, altfel.
+ */
+int ht_has_key(hashtable_t *ht, void *key)
+{
+    return ht_find_slot(ht, key, ht->hash_function(key)) != NULL;
+}
+
+void *ht_get(hashtable_t *ht, void *key)
+{
+    ht_slot_t *slot = ht_find_slot(ht, key, ht->hash_function(key));
+
+    if (slot == NULL)
+        return NULL;
+
+    return slot->entry.value;
+}
+
+/*
+ * La fel ca in varianta cu liste, cheia si valoarea se copiaza. Copiile sunt
+ * puse intr-un singur bloc: cheia la inceput, valoarea imediat dupa, aliniata
+ * la sizeof(void*). Intoarce 0 la succes si -1 daca tabela nu mai poate
+ * creste si nu mai are loc (ramane mereu cel putin un slot liber).
+ */
+int ht_put(hashtable_t *ht, void *key, unsigned int key_size,
+	void *value, unsigned int value_size)
+{
+    unsigned int hash = ht->hash_function(key);
+    ht_slot_t *found = ht_find_slot(ht, key, hash);
+
+    if (found != NULL) {
+        memcpy(found->entry.value, value, value_size);
+        return 0;
+    }
+
+    if ((unsigned long)(ht->size + 1) * HT_LOAD_DEN >
+        (unsigned long)ht->hmax * HT_LOAD_NUM &&
+        ht_grow(ht) != 0 && ht->size + 1 >= ht->hmax)
+        return -1;
+
+    unsigned int value_off = (key_size + sizeof(void*) - 1) &
+                             ~(unsigned int)(sizeof(void*) - 1);
+    char *block = malloc(value_off + value_size);
+    memcpy(block, key, key_size);
+    memcpy(block + value_off, value, value_size);
+
+    ht_slot_t slot;
+    slot.hash = hash;
+    slot.entry.key = block;
+    slot.entry.value = block + value_off;
+
+    ht_insert_slot(ht, slot);
+    ht->size++;
+    return 0;
+}
+
+/*
+ * Procedura care elimina din hashtable intrarea asociata cheii key.
+ * Dupa stergere, intrarile urmatoare din acelasi cluster sunt mutate cu o
+ * pozitie la stanga (backward shift), deci nu avem nevoie de "tombstones".
+ */
+void ht_remove_entry(hashtable_t *ht, void *key)
+{
+    ht_slot_t *slot = ht_find_slot(ht, key, ht->hash_function(key));
+    unsigned int mask = ht->hmax - 1;
+
+    if (slot == NULL)
+        return;
+
+    ht->key_val_free_function(&slot->entry);
+    ht->size--;
+
+    unsigned int pos = slot - ht->slots;
+    unsigned int next = (pos + 1) & mask;
+    while (ht->slots[next].dist > 1) {
+        ht->slots[pos] = ht->slots[next];
+        ht->slots[pos].dist--;
+        pos = next;
+        next = (next + 1) & mask;
+    }
+    ht->slots[pos].dist = 0;
+}
+
+/*
+ * Procedura care elibereaza memoria folosita de toate intrarile din hashtable,
+ * dupa care elibereaza si memoria folosita pentru a stoca structura hashtable.
+ */
+void ht_free(hashtable_t *ht)
+{
+    for (unsigned int i = 0; i < ht->hmax; ++i) {
+        if (ht->slots[i].dist != 0)
+            ht->key_val_free_function(&ht->slots[i].entry);
+    }
+
+    free(ht->slots);
+    free(ht);
+}
+
+unsigned int ht_get_size(hashtable_t *ht)
+{
+	if (ht == NULL)
+		return 0;
+
+	return ht->size;
+}
+
+unsigned int ht_get_hmax(hashtable_t *ht)
+{
+	if (ht == NULL)
+		return 0;
+
+	return ht->hmax;
+}
+
+struct FriendInfo {
+	char name[MAX_STRING_SIZE];
+	char faculty[MAX_STRING_SIZE];
+	char fav_food[MAX_STRING_SIZE];
+	int age;
+};
+
+static void print_friend(struct FriendInfo *f_info)
+{
+	if (f_info == NULL) {
+		printf("Friend doesn't exist!\n");
+		return;
+	}
+	printf("Name: %s | ", f_info->name);
+	printf("Age: %d | ", f_info->age);
+	printf("Faculty: %s | ", f_info->faculty);
+	printf("Favorite food: %s\n", f_info->fav_food);
+}
+
+int main()
+{
+	hashtable_t *ht_friends = NULL;
+	struct FriendInfo info_f;
+	struct FriendInfo *p_infoFriend;
+
+	while (1) {
+		char command[MAX_STRING_SIZE];
+
+		if (scanf("%s", command) != 1)
+			break;
+		if (strncmp(command, "create_ht", 9) == 0) {
+			ht_friends = ht_create(HMAX, hash_function_string,
+				compare_function_strings, key_val_free_function);
+
+		} else if (strncmp(command, "add_friend", 10) == 0) {
+			scanf("%s %d %s %s", info_f.name, &info_f.age,
+				info_f.faculty, info_f.fav_food);
+
+			if (!ht_friends) {
+				printf("Create hashtable first.\n");
+			} else {
+				if (ht_put(ht_friends, info_f.name, strlen(info_f.name) + 1,
+					&info_f, sizeof(info_f)) != 0)
+					printf("Could not add friend %s.\n", info_f.name);
+			}
+
+		} else if (strncmp(command, "print_friend", 12) == 0) {
+			char name[MAX_STRING_SIZE];
+
+			scanf("%s", name);
+
+			if (!ht_friends) {
+				printf("Create hashtable first.\n");
+			} else {
+				p_infoFriend = ht_get(ht_friends, name);
+				print_friend(p_infoFriend);
+			}
+
+		} else if (strncmp(command, "check_friend", 12) == 0) {
+			char name[MAX_STRING_SIZE];
+
+			scanf("%s", name);
+			if (!ht_friends) {
+				printf("Create hashtable first.\n");
+			} else if(ht_has_key(ht_friends, name)) {
+				printf("Friend %s exists.\n", name);
+			} else {
+				printf("Friend %s doesn't exist.\n", name);
+			}
+
+		} else if (strncmp(command, "remove_friend", 13) == 0) {
+			char name[MAX_STRING_SIZE];
+
+			scanf("%s", name);
+			if (!ht_friends) {
+				printf("Create hashtable first.\n");
+			} else {
+				ht_remove_entry(ht_friends, name);
+			}
+
+		} else if (strncmp(command, "free", 4) == 0) {
+			if (!ht_friends) {
+				printf("Create hashtable first.\n");
+			} else {
+				ht_free(ht_friends);
+			}
+			break;
+		}
+	}
+
+	return 0;
+}
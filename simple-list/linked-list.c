@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
+#include <time.h>
 
 #define DIE(assertion, call_description)				\
 	do {								\
@@ -21,11 +22,32 @@ typedef struct ll_node_t
     struct ll_node_t* next;
 } ll_node_t;
 
+/*
+ * Nodurile unei liste se aloca dintr-un pool propriu listei: fiecare nod e un
+ * singur bloc de node_size octeti (structura ll_node_t urmata de cei data_size
+ * octeti ai datelor, spre care pointeaza data), luat din slab-uri de
+ * LL_SLAB_NODES blocuri. Nodurile eliberate intra intr-o lista de blocuri
+ * libere si sunt refolosite de urmatoarele adaugari, deci in regim stabil
+ * adaugarile si eliminarile nu mai apeleaza deloc malloc / free.
+ */
+#define LL_SLAB_NODES 256
+
+typedef struct ll_slab_t
+{
+    struct ll_slab_t* next;
+    size_t used; /* Cate blocuri au fost deja date din acest slab. */
+    char blocks[];
+} ll_slab_t;
+
 typedef struct linked_list_t
 {
     ll_node_t* head;
+    ll_node_t* tail; /* Ultimul nod, ca adaugarea la final sa fie O(1). */
     unsigned int data_size;
     unsigned int size;
+    unsigned int node_size; /* sizeof(ll_node_t) + data_size, aliniat la 8. */
+    ll_slab_t* slabs;
+    ll_node_t* free_nodes; /* Blocuri eliberate, inlantuite prin next. */
 } linked_list_t;
 
 linked_list_t*
@@ -33,17 +55,62 @@ ll_create(unsigned int data_size)
 {
     linked_list_t *temp = malloc(sizeof(linked_list_t));
 	temp->head = NULL;
+	temp->tail = NULL;
 	temp->size = 0;
 	temp->data_size = data_size;
+	temp->node_size = (sizeof(ll_node_t) + data_size + 7) & ~7u;
+	temp->slabs = NULL;
+	temp->free_nodes = NULL;
 	return temp;
 }
 
+/*
+ * Intoarce un nod nou (cu data pointand in acelasi bloc), luat din lista de
+ * blocuri libere sau din slab-ul curent.
+ */
+static ll_node_t*
+ll_alloc_node(linked_list_t* list)
+{
+    ll_node_t *node = list->free_nodes;
+
+    if (node != NULL) {
+        list->free_nodes = node->next;
+        return node;
+    }
+
+    ll_slab_t *slab = list->slabs;
+    if (slab == NULL || slab->used == LL_SLAB_NODES) {
+        slab = malloc(sizeof(ll_slab_t) +
+                      (size_t)LL_SLAB_NODES * list->node_size);
+        DIE(slab == NULL, "slab malloc");
+        slab->next = list->slabs;
+        slab->used = 0;
+        list->slabs = slab;
+    }
+
+    node = (ll_node_t *)(slab->blocks + (size_t)slab->used * list->node_size);
+    slab->used++;
+    node->data = node + 1;
+    return node;
+}
+
+/*
+ * Returneaza in pool un nod intors de ll_remove_nth_node / ll_pop_front.
+ * Nodul si datele lui sunt un singur bloc, deci NU se face free pe data.
+ */
+void
+ll_free_node(linked_list_t* list, ll_node_t* node)
+{
+    node->next = list->free_nodes;
+    list->free_nodes = node;
+}
+
 /*
  * Pe baza datelor trimise prin pointerul new_data, se creeaza un nou nod care e
  * adaugat pe pozitia n a listei reprezentata de pointerul list. Pozitiile din
  * lista sunt indexate incepand cu 0 (i.e. primul nod din lista se afla pe
- * pozitia n=0). Daca n >= nr_noduri, noul nod se adauga la finalul listei. Daca
- * n < 0, ignorati comanda (iesiti din functie).
+ * pozitia n=0). Daca n >= nr_noduri, noul nod se adauga la finalul listei, in
+ * O(1) (prin tail). Daca n < 0, ignorati comanda (iesiti din functie).
  */
 void
 ll_add_nth_node(linked_list_t* list, unsigned int n, const void* new_data)
@@ -53,22 +120,30 @@ ll_add_nth_node(linked_list_t* list, unsigned int n, const void* new_data)
         return;
     if(n > list->size) 
         n = list->size;
-    ll_node_t *temp = malloc(sizeof(ll_node_t));
-	
-    temp->data = malloc(list->data_size);
-	
+    ll_node_t *temp = ll_alloc_node(list);
+
     memcpy(temp->data, new_data, list->data_size);
 
 	temp->next = NULL;
-    
-    list->size++;
 
     if (n == 0) {
         temp->next = list->head;
         list->head = temp;
+        if (list->tail == NULL)
+            list->tail = temp;
+        list->size++;
         return;
     }
 
+    if (n == list->size) {
+        list->tail->next = temp;
+        list->tail = temp;
+        list->size++;
+        return;
+    }
+
+    list->size++;
+
 	ll_node_t *travel = list->head;
     for(int i=0; i < n-1; i++) {
         travel = travel->next;
@@ -84,12 +159,12 @@ ll_add_nth_node(linked_list_t* list, unsigned int n, const void* new_data)
  * lista se afla pe pozitia n=0). Daca n >= nr_noduri - 1, se elimina nodul de
  * la finalul listei. Daca n < 0, ignorati comanda (iesiti din functie).
  * Functia intoarce un pointer spre acest nod proaspat eliminat din lista.
- * Este responsabilitatea apelantului sa elibereze memoria acestui nod.
+ * Este responsabilitatea apelantului sa elibereze nodul, cu ll_free_node.
  */
 ll_node_t*
 ll_remove_nth_node(linked_list_t* list, unsigned int n)
 {
-	if (n < 0) {
+	if (n < 0 || list->size == 0) {
 		return NULL;
 	}
 
@@ -102,6 +177,8 @@ ll_remove_nth_node(linked_list_t* list, unsigned int n)
     if (n == 0) {
         ll_node_t *temp = list->head;
         list->head = temp->next;
+        if (list->head == NULL)
+            list->tail = NULL;
         return temp;
     }
 	ll_node_t *travel = list->head;
@@ -110,10 +187,42 @@ ll_remove_nth_node(linked_list_t* list, unsigned int n)
 	}
 	ll_node_t *temp = travel->next;
 	travel->next = temp->next;
+	if (temp == list->tail)
+		list->tail = travel;
 
 	return temp;
 }
 
+/*
+ * Adauga un nod nou cu o copie a datelor new_data la inceputul listei. O(1).
+ */
+void
+ll_push_front(linked_list_t* list, const void* new_data)
+{
+    ll_add_nth_node(list, 0, new_data);
+}
+
+/*
+ * Adauga un nod nou cu o copie a datelor new_data la finalul listei. Folosind
+ * pointerul tail, operatia e O(1), deci construirea unei liste cu n noduri
+ * prin adaugari la final e O(n), nu O(n^2).
+ */
+void
+ll_push_back(linked_list_t* list, const void* new_data)
+{
+    ll_add_nth_node(list, list->size, new_data);
+}
+
+/*
+ * Scoate primul nod din lista si il intoarce (NULL daca lista e goala). O(1).
+ * Este responsabilitatea apelantului sa elibereze nodul, cu ll_free_node.
+ */
+ll_node_t*
+ll_pop_front(linked_list_t* list)
+{
+    return ll_remove_nth_node(list, 0);
+}
+
 /*
  * Functia intoarce numarul de noduri din lista al carei pointer este trimis ca
  * parametru.
@@ -128,16 +237,16 @@ ll_get_size(linked_list_t* list)
  * Procedura elibereaza memoria folosita de toate nodurile din lista, iar la
  * sfarsit, elibereaza memoria folosita de structura lista si actualizeaza la
  * NULL valoarea pointerului la care pointeaza argumentul (argumentul este un
- * pointer la un pointer).
+ * pointer la un pointer). Nodurile traiesc in slab-urile listei, deci se
+ * elibereaza slab-urile, fara sa se parcurga nodurile.
  */
 void
 ll_free(linked_list_t** pp_list)
 {
-	ll_node_t *travel = (*pp_list)->head;
-	while (travel != NULL) {
-		ll_node_t *temp = travel;
-		travel = travel->next;
-		free(temp->data);
+	ll_slab_t *slab = (*pp_list)->slabs;
+	while (slab != NULL) {
+		ll_slab_t *temp = slab;
+		slab = slab->next;
 		free(temp);
 	}
 
@@ -177,6 +286,199 @@ ll_print_string(linked_list_t* list)
     printf("\n");
 }
 
+/*
+ * Interclaseaza doua lanturi de noduri sortate (terminate cu NULL) si intoarce
+ * capul lantului rezultat. La egalitate nodul din a ramane primul, deci
+ * interclasarea e stabila. Nu aloca nimic: doar reface legaturile next.
+ */
+static ll_node_t*
+ll_merge_chains(ll_node_t* a, ll_node_t* b,
+                int (*cmp)(const void*, const void*))
+{
+    ll_node_t head, *last = &head;
+
+    while (a != NULL && b != NULL) {
+        if (cmp(b->data, a->data) < 0) {
+            last->next = b;
+            b = b->next;
+        } else {
+            last->next = a;
+            a = a->next;
+        }
+        last = last->next;
+    }
+
+    last->next = a != NULL ? a : b;
+    return head.next;
+}
+
+/*
+ * Sorteaza stabil lista, in-place, dupa comparatorul cmp (aplicat pe data),
+ * fara nicio alocare: merge sort de jos in sus. bins[i] tine un lant sortat de
+ * 2^i noduri; fiecare nod nou se "aduna" ca la un contor binar, interclasand
+ * lanturile de aceeasi marime. Lanturile din bins de rang mai mare contin
+ * noduri mai vechi, deci sunt mereu primul argument al interclasarii.
+ * O(n log n) comparatii, O(log n) memorie pe stiva.
+ */
+void
+ll_sort(linked_list_t* list, int (*cmp)(const void*, const void*))
+{
+    ll_node_t *bins[64] = {NULL};
+    unsigned int used = 0;
+    ll_node_t *node = list->head;
+
+    while (node != NULL) {
+        ll_node_t *carry = node;
+        unsigned int i;
+
+        node = node->next;
+        carry->next = NULL;
+
+        for (i = 0; i < used && bins[i] != NULL; ++i) {
+            carry = ll_merge_chains(bins[i], carry, cmp);
+            bins[i] = NULL;
+        }
+        bins[i] = carry;
+        if (i == used)
+            used++;
+    }
+
+    ll_node_t *result = NULL;
+    for (unsigned int i = 0; i < used; ++i) {
+        if (bins[i] != NULL)
+            result = ll_merge_chains(bins[i], result, cmp);
+    }
+
+    /* Coada se cauta o singura data, la final. */
+    ll_node_t *tail = result;
+    while (tail != NULL && tail->next != NULL)
+        tail = tail->next;
+
+    list->head = result;
+    list->tail = tail;
+}
+
+/*
+ * Interclaseaza lista sortata src in lista sortata dst (stabil, nodurile din
+ * dst raman inaintea celor egale din src). Nodurile nu se copiaza, se muta
+ * cu tot cu slab-urile si blocurile libere ale lui src, deci src ramane goala
+ * (dar utilizabila). Listele trebuie sa aiba acelasi data_size.
+ */
+void
+ll_merge(linked_list_t* dst, linked_list_t* src,
+         int (*cmp)(const void*, const void*))
+{
+    if (dst == NULL || src == NULL || dst == src ||
+        dst->data_size != src->data_size)
+        return;
+
+    /*
+     * Ultimul nod al rezultatului e coada lui src, afara de cazul in care
+     * coada lui dst e strict mai mare (la egalitate src vine dupa dst).
+     */
+    if (src->tail != NULL &&
+        (dst->tail == NULL || cmp(src->tail->data, dst->tail->data) >= 0))
+        dst->tail = src->tail;
+    dst->head = ll_merge_chains(dst->head, src->head, cmp);
+    dst->size += src->size;
+
+    if (src->slabs != NULL) {
+        ll_slab_t *last = src->slabs;
+        while (last->next != NULL)
+            last = last->next;
+        /* Slab-ul curent al lui dst ramane primul, ca sa se umple in continuare. */
+        if (dst->slabs != NULL) {
+            last->next = dst->slabs->next;
+            dst->slabs->next = src->slabs;
+        } else {
+            dst->slabs = src->slabs;
+        }
+    }
+
+    if (src->free_nodes != NULL) {
+        ll_node_t *last = src->free_nodes;
+        while (last->next != NULL)
+            last = last->next;
+        last->next = dst->free_nodes;
+        dst->free_nodes = src->free_nodes;
+    }
+
+    src->head = NULL;
+    src->tail = NULL;
+    src->size = 0;
+    src->slabs = NULL;
+    src->free_nodes = NULL;
+}
+
+static int
+compare_ints(const void* a, const void* b)
+{
+    int x = *(const int*)a, y = *(const int*)b;
+
+    return (x > y) - (x < y);
+}
+
+static int
+compare_strings(const void* a, const void* b)
+{
+    return strcmp(a, b);
+}
+
+static double
+now_sec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/*
+ * Compara ll_sort cu varianta "copiaza intr-un array, qsort, reconstruieste
+ * lista" pe o lista de n int-uri aleatoare.
+ */
+void
+bench_sort(unsigned int n)
+{
+    linked_list_t *a = ll_create(sizeof(int));
+    linked_list_t *b = ll_create(sizeof(int));
+
+    srand(19);
+    for (unsigned int i = 0; i < n; ++i) {
+        int x = rand();
+        ll_push_back(a, &x);
+        ll_push_back(b, &x);
+    }
+
+    double start = now_sec();
+    ll_sort(a, compare_ints);
+    double merge = now_sec() - start;
+
+    start = now_sec();
+    int *array = malloc((size_t)n * sizeof(int));
+    unsigned int k = 0;
+    for (ll_node_t *node = b->head; node != NULL; node = node->next)
+        array[k++] = *(int*)node->data;
+    qsort(array, n, sizeof(int), compare_ints);
+    ll_free(&b);
+    b = ll_create(sizeof(int));
+    for (unsigned int i = 0; i < n; ++i)
+        ll_push_back(b, &array[i]);
+    free(array);
+    double copy = now_sec() - start;
+
+    int same = 1;
+    ll_node_t *x = a->head, *y = b->head;
+    for (; x != NULL && y != NULL; x = x->next, y = y->next)
+        same &= *(int*)x->data == *(int*)y->data;
+
+    printf("ll_sort: %.2f ms | copy + qsort + rebuild: %.2f ms | %s\n",
+           merge * 1e3, copy * 1e3, same && x == y ? "same" : "DIFFERENT");
+
+    ll_free(&a);
+    ll_free(&b);
+}
+
 int main()
 {
     linked_list_t* linkedList;
@@ -187,7 +489,8 @@ int main()
         char command[16], added_elem[64], *end_ptr;
         long nr, pos;
 
-        scanf("%s", command);
+        if (scanf("%15s", command) != 1)
+            break;
 
         if (strcmp(command, "create_str") == 0) {
             linkedList = ll_create(MAX_STRING_SIZE);
@@ -216,11 +519,40 @@ int main()
             ll_node_t *removed = ll_remove_nth_node(linkedList, pos);
             if (removed == NULL) ;
             else {
-                free(removed->data);
-            free(removed);
+                ll_free_node(linkedList, removed);
             }// facut de mine pt teste
         }
 
+        if (strcmp(command, "push_front") == 0 ||
+            strcmp(command, "push_back") == 0) {
+            scanf("%s", added_elem);
+
+            nr = strtol(added_elem, &end_ptr, 10);
+            void *data = nr != 0 ? (void *)&nr : (void *)end_ptr;
+            if (command[5] == 'f')
+                ll_push_front(linkedList, data);
+            else
+                ll_push_back(linkedList, data);
+        }
+
+        if (strcmp(command, "pop_front") == 0) {
+            ll_node_t *removed = ll_pop_front(linkedList);
+            if (removed != NULL) {
+                ll_free_node(linkedList, removed);
+            }
+        }
+
+        if (strcmp(command, "sort") == 0) {
+            ll_sort(linkedList, is_int ? compare_ints : compare_strings);
+        }
+
+        if (strcmp(command, "bench_sort") == 0) {
+            unsigned int n;
+
+            scanf("%u", &n);
+            bench_sort(n);
+        }
+
         if (strcmp(command, "print") == 0) {
             if (is_int == 1) {
                 ll_print_int(linkedList);
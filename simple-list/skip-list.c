@@ -0,0 +1,464 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+
+#define DIE(assertion, call_description)				\
+	do {								\
+		if (assertion) {					\
+			fprintf(stderr, "(%s, %d): ",			\
+					__FILE__, __LINE__);		\
+			perror(call_description);			\
+			exit(errno);				        \
+		}							\
+	} while (0)
+
+#define MAX_STRING_SIZE 64
+
+/*
+ * Varianta cu skip list a listei din linked-list.c, cu acelasi API pozitional
+ * (ll_add_nth_node / ll_remove_nth_node / ll_get_nth_node) si aceeasi copiere
+ * a data_size octeti. Fiecare nod are un nr. aleator de niveluri (fiecare nivel
+ * in plus cu probabilitate 1 / SL_BRANCH), iar fiecare legatura retine si
+ * cate pozitii sare (span). Coborand de pe nivelul cel mai de sus si adunand
+ * span-urile, ajungem la pozitia n in O(log n) pasi in medie, in loc sa
+ * parcurgem n noduri.
+ *
+ * Lista incepe cu un nod santinela (head) cu SL_MAX_LEVEL niveluri, pe pozitia
+ * "-1"; primul element are rangul 1. Span-ul unei legaturi spre NULL este
+ * numarul de elemente ramase dupa nodul de la care pleaca.
+ */
+#define SL_MAX_LEVEL 32
+#define SL_BRANCH 4
+
+typedef struct sl_link_t
+{
+    struct ll_node_t* next;
+    unsigned int span; /* Cu cate pozitii avanseaza legatura. */
+} sl_link_t;
+
+typedef struct ll_node_t
+{
+    void* data; /* Pointeaza in acelasi bloc, dupa links[level - 1]. */
+    unsigned int level;
+    sl_link_t links[];
+} ll_node_t;
+
+typedef struct linked_list_t
+{
+    ll_node_t* head; /* Santinela; nu contine date. */
+    unsigned int data_size;
+    unsigned int size;
+    unsigned int level; /* Nr. de niveluri folosite de cel putin un nod. */
+    unsigned int rng; /* Starea generatorului pentru nivelurile nodurilor. */
+} linked_list_t;
+
+static ll_node_t*
+sl_node_create(unsigned int level, unsigned int data_size)
+{
+    ll_node_t *node = malloc(sizeof(ll_node_t) + level * sizeof(sl_link_t) +
+                             data_size);
+    DIE(node == NULL, "skip list node malloc");
+
+    node->level = level;
+    node->data = &node->links[level];
+    for (unsigned int i = 0; i < level; ++i) {
+        node->links[i].next = NULL;
+        node->links[i].span = 0;
+    }
+
+    return node;
+}
+
+linked_list_t*
+ll_create(unsigned int data_size)
+{
+    linked_list_t *temp = malloc(sizeof(linked_list_t));
+    DIE(temp == NULL, "linked_list malloc");
+
+    temp->head = sl_node_create(SL_MAX_LEVEL, 0);
+    temp->data_size = data_size;
+    temp->size = 0;
+    temp->level = 1;
+    temp->rng = 2463534242u;
+
+    return temp;
+}
+
+/*
+ * Nivelul unui nod nou: 1, plus cate un nivel cu probabilitate 1 / SL_BRANCH.
+ */
+static unsigned int
+sl_random_level(linked_list_t* list)
+{
+    unsigned int level = 1;
+
+    while (level < SL_MAX_LEVEL) {
+        unsigned int x = list->rng;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        list->rng = x;
+
+        if (x % SL_BRANCH != 0)
+            break;
+        level++;
+    }
+
+    return level;
+}
+
+/*
+ * Pentru fiecare nivel i, update[i] devine ultimul nod cu rangul <= n (adica
+ * predecesorul pozitiei n), iar rank[i] rangul lui.
+ */
+static void
+sl_find(linked_list_t* list, unsigned int n, ll_node_t** update,
+        unsigned int* rank)
+{
+    ll_node_t *x = list->head;
+    unsigned int pos = 0;
+
+    for (int i = list->level - 1; i >= 0; --i) {
+        while (x->links[i].next != NULL && pos + x->links[i].span <= n) {
+            pos += x->links[i].span;
+            x = x->links[i].next;
+        }
+        update[i] = x;
+        rank[i] = pos;
+    }
+}
+
+/*
+ * Pe baza datelor trimise prin pointerul new_data, se creeaza un nou nod care e
+ * adaugat pe pozitia n a listei. Pozitiile sunt indexate incepand cu 0. Daca
+ * n >= nr_noduri, noul nod se adauga la finalul listei. O(log n) in medie.
+ */
+void
+ll_add_nth_node(linked_list_t* list, unsigned int n, const void* new_data)
+{
+    ll_node_t *update[SL_MAX_LEVEL];
+    unsigned int rank[SL_MAX_LEVEL];
+
+    if (list == NULL)
+        return;
+
+    if (n > list->size)
+        n = list->size;
+
+    sl_find(list, n, update, rank);
+
+    unsigned int level = sl_random_level(list);
+    if (level > list->level) {
+        for (unsigned int i = list->level; i < level; ++i) {
+            update[i] = list->head;
+            rank[i] = 0;
+            list->head->links[i].span = list->size;
+        }
+        list->level = level;
+    }
+
+    ll_node_t *x = sl_node_create(level, list->data_size);
+    memcpy(x->data, new_data, list->data_size);
+
+    for (unsigned int i = 0; i < level; ++i) {
+        x->links[i].next = update[i]->links[i].next;
+        update[i]->links[i].next = x;
+
+        /* update[i] e pe rangul rank[i], iar x pe rangul rank[0] + 1. */
+        x->links[i].span = update[i]->links[i].span - (rank[0] - rank[i]);
+        update[i]->links[i].span = rank[0] - rank[i] + 1;
+    }
+
+    /* Legaturile de deasupra lui x trec acum peste un element in plus. */
+    for (unsigned int i = level; i < list->level; ++i)
+        update[i]->links[i].span++;
+
+    list->size++;
+}
+
+/*
+ * Elimina nodul de pe pozitia n din lista. Daca n >= nr_noduri - 1, se elimina
+ * nodul de la finalul listei. Functia intoarce un pointer spre acest nod (NULL
+ * daca lista e goala); apelantul il elibereaza cu ll_free_node. O(log n) in
+ * medie.
+ */
+ll_node_t*
+ll_remove_nth_node(linked_list_t* list, unsigned int n)
+{
+    ll_node_t *update[SL_MAX_LEVEL];
+    unsigned int rank[SL_MAX_LEVEL];
+
+    if (list == NULL || list->size == 0)
+        return NULL;
+
+    if (n >= list->size)
+        n = list->size - 1;
+
+    sl_find(list, n, update, rank);
+    ll_node_t *x = update[0]->links[0].next;
+
+    for (unsigned int i = 0; i < list->level; ++i) {
+        if (update[i]->links[i].next == x) {
+            update[i]->links[i].span += x->links[i].span - 1;
+            update[i]->links[i].next = x->links[i].next;
+        } else {
+            update[i]->links[i].span--;
+        }
+    }
+
+    while (list->level > 1 && list->head->links[list->level - 1].next == NULL)
+        list->level--;
+
+    list->size--;
+    return x;
+}
+
+/*
+ * Intoarce datele nodului de pe pozitia n (NULL daca n >= nr_noduri).
+ */
+void*
+ll_get_nth_node(linked_list_t* list, unsigned int n)
+{
+    ll_node_t *update[SL_MAX_LEVEL];
+    unsigned int rank[SL_MAX_LEVEL];
+
+    if (list == NULL || n >= list->size)
+        return NULL;
+
+    sl_find(list, n, update, rank);
+    return update[0]->links[0].next->data;
+}
+
+/*
+ * Nodul si datele lui sunt un singur bloc.
+ */
+void
+ll_free_node(linked_list_t* list, ll_node_t* node)
+{
+    (void)list;
+    free(node);
+}
+
+void
+ll_push_front(linked_list_t* list, const void* new_data)
+{
+    ll_add_nth_node(list, 0, new_data);
+}
+
+void
+ll_push_back(linked_list_t* list, const void* new_data)
+{
+    ll_add_nth_node(list, list->size, new_data);
+}
+
+ll_node_t*
+ll_pop_front(linked_list_t* list)
+{
+    return ll_remove_nth_node(list, 0);
+}
+
+/*
+ * Functia intoarce numarul de noduri din lista al carei pointer este trimis ca
+ * parametru.
+ */
+unsigned int
+ll_get_size(linked_list_t* list)
+{
+    return list->size;
+}
+
+/*
+ * Procedura elibereaza memoria folosita de toate nodurile din lista (pe
+ * nivelul 0 apar toate), apoi santinela si structura lista, si actualizeaza
+ * la NULL valoarea pointerului la care pointeaza argumentul.
+ */
+void
+ll_free(linked_list_t** pp_list)
+{
+	ll_node_t *travel = (*pp_list)->head;
+	while (travel != NULL) {
+		ll_node_t *temp = travel;
+		travel = travel->links[0].next;
+		free(temp);
+	}
+
+	free(*pp_list);
+	*pp_list = NULL;
+}
+
+/*
+ * Atentie! Aceasta functie poate fi apelata doar pe liste ale caror noduri STIM
+ * ca stocheaza int-uri. Functia afiseaza toate valorile int stocate in nodurile
+ * din lista separate printr-un spatiu.
+ */
+void
+ll_print_int(linked_list_t* list)
+{
+    ll_node_t *travel = list->head->links[0].next;
+    while (travel != NULL) {
+        printf("%d ", *(int*)travel->data);
+        travel = travel->links[0].next;
+    }
+    printf("\n");
+}
+
+/*
+ * Atentie! Aceasta functie poate fi apelata doar pe liste ale caror noduri STIM
+ * ca stocheaza string-uri. Functia afiseaza toate string-urile stocate in
+ * nodurile din lista, separate printr-un spatiu.
+ */
+void
+ll_print_string(linked_list_t* list)
+{
+    ll_node_t *travel = list->head->links[0].next;
+    while (travel != NULL) {
+        printf("%s ", (char*)travel->data);
+        travel = travel->links[0].next;
+    }
+    printf("\n");
+}
+
+static double now_sec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/*
+ * Construieste o lista de n int-uri prin inserari pe pozitii aleatoare, apoi
+ * face n citiri si n eliminari de pe pozitii aleatoare si afiseaza timpul
+ * mediu pe operatie.
+ */
+void
+bench_positional(unsigned int n)
+{
+    linked_list_t *list = ll_create(sizeof(int));
+    long sink = 0;
+
+    srand(17);
+    double start = now_sec();
+    for (unsigned int i = 0; i < n; ++i)
+        ll_add_nth_node(list, rand() % (list->size + 1), &i);
+    double add = now_sec() - start;
+
+    start = now_sec();
+    for (unsigned int i = 0; i < n; ++i)
+        sink += *(int*)ll_get_nth_node(list, rand() % list->size);
+    double get = now_sec() - start;
+
+    start = now_sec();
+    for (unsigned int i = 0; i < n; ++i)
+        ll_free_node(list, ll_remove_nth_node(list, rand() % list->size));
+    double removal = now_sec() - start;
+
+    printf("add: %.2f ns | get: %.2f ns | remove: %.2f ns\n", add * 1e9 / n,
+           get * 1e9 / n, removal * 1e9 / n);
+
+    ll_free(&list);
+    if (sink == 42)
+        printf("\n");
+}
+
+int main()
+{
+    linked_list_t* linkedList;
+    int is_int = 0;
+    int is_string = 0;
+
+    while (1) {
+        char command[24], added_elem[64], *end_ptr;
+        long nr, pos;
+
+        if (scanf("%23s", command) != 1)
+            break;
+
+        if (strcmp(command, "create_str") == 0) {
+            linkedList = ll_create(MAX_STRING_SIZE);
+            is_string = 1;
+        }
+
+        if (strcmp(command, "create_int") == 0) {
+            linkedList = ll_create(sizeof(int));
+            is_int = 1;
+        }
+
+        if (strcmp(command, "add") == 0) {
+            scanf("%ld", &pos);
+            scanf("%63s", added_elem);
+
+            nr = strtol(added_elem, &end_ptr, 10);
+            if (nr != 0) {
+                ll_add_nth_node(linkedList, pos, &nr);
+            } else {
+                ll_add_nth_node(linkedList, pos, end_ptr);
+            }
+        }
+
+        if (strcmp(command, "push_front") == 0 ||
+            strcmp(command, "push_back") == 0) {
+            scanf("%63s", added_elem);
+
+            nr = strtol(added_elem, &end_ptr, 10);
+            void *data = nr != 0 ? (void *)&nr : (void *)end_ptr;
+            if (command[5] == 'f')
+                ll_push_front(linkedList, data);
+            else
+                ll_push_back(linkedList, data);
+        }
+
+        if (strcmp(command, "remove") == 0) {
+            scanf("%ld", &pos);
+            ll_node_t *removed = ll_remove_nth_node(linkedList, pos);
+            if (removed != NULL) {
+                ll_free_node(linkedList, removed);
+            }
+        }
+
+        if (strcmp(command, "pop_front") == 0) {
+            ll_node_t *removed = ll_pop_front(linkedList);
+            if (removed != NULL) {
+                ll_free_node(linkedList, removed);
+            }
+        }
+
+        if (strcmp(command, "get") == 0) {
+            scanf("%ld", &pos);
+            void *data = ll_get_nth_node(linkedList, pos);
+
+            if (data == NULL)
+                printf("Position %ld doesn't exist.\n", pos);
+            else if (is_int == 1)
+                printf("%d\n", *(int*)data);
+            else
+                printf("%s\n", (char*)data);
+        }
+
+        if (strcmp(command, "print") == 0) {
+            if (is_int == 1) {
+                ll_print_int(linkedList);
+            }
+
+            if (is_string == 1) {
+                ll_print_string(linkedList);
+            }
+        }
+
+        if (strcmp(command, "bench_positional") == 0) {
+            unsigned int n;
+
+            scanf("%u", &n);
+            bench_positional(n);
+        }
+
+        if (strcmp(command, "free") == 0) {
+            ll_free(&linkedList);
+            break;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,373 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#define DIE(assertion, call_description)				\
+	do {								\
+		if (assertion) {					\
+			fprintf(stderr, "(%s, %d): ",			\
+					__FILE__, __LINE__);		\
+			perror(call_description);			\
+			exit(errno);				        \
+		}							\
+	} while (0)
+
+#define MAX_STRING_SIZE 64
+
+/*
+ * Varianta "unrolled" a listei din linked-list.c. Fiecare nod tine direct in
+ * el un bloc de pana la per_node elemente de data_size octeti, asezate unul
+ * dupa altul, in loc de un singur pointer data spre un malloc separat. Nodurile
+ * au UL_NODE_BYTES octeti (multiplu de linia de cache), deci o parcurgere face
+ * un salt de pointer la per_node elemente, iar o adaugare face un malloc doar
+ * cand nodul e plin.
+ *
+ * Pozitiile se indexeaza ca in linked-list.c: ll_add_nth_node si
+ * ll_remove_nth_node primesc pozitia elementului in toata lista. Cum
+ * elementele nu mai au noduri proprii, ll_remove_nth_node copiaza elementul
+ * eliminat intr-un buffer al apelantului in loc sa intoarca un nod.
+ */
+#define UL_CACHE_LINE 64
+#define UL_NODE_BYTES (4 * UL_CACHE_LINE)
+
+typedef struct ul_node_t
+{
+    struct ul_node_t* next;
+    unsigned int count; /* Cate elemente sunt folosite din data. */
+    char data[]; /* per_node * data_size octeti. */
+} ul_node_t;
+
+typedef struct linked_list_t
+{
+    ul_node_t* head;
+    ul_node_t* tail;
+    unsigned int data_size;
+    unsigned int size;
+    unsigned int per_node; /* Capacitatea unui nod, in elemente. */
+} linked_list_t;
+
+linked_list_t*
+ll_create(unsigned int data_size)
+{
+    linked_list_t *temp = malloc(sizeof(linked_list_t));
+    DIE(temp == NULL, "linked_list malloc");
+
+    temp->head = NULL;
+    temp->tail = NULL;
+    temp->size = 0;
+    temp->data_size = data_size;
+
+    /* Elementele de 0 octeti se numara ca avand 1, ca sa nu impartim la 0. */
+    unsigned int room = UL_NODE_BYTES - sizeof(ul_node_t);
+    unsigned int elem = data_size ? data_size : 1;
+    temp->per_node = elem < room ? room / elem : 1;
+
+    return temp;
+}
+
+static inline char*
+ul_elem(linked_list_t* list, ul_node_t* node, unsigned int i)
+{
+    return node->data + (size_t)i * list->data_size;
+}
+
+static ul_node_t*
+ul_node_create(linked_list_t* list)
+{
+    size_t bytes = sizeof(ul_node_t) + (size_t)list->per_node * list->data_size;
+
+    bytes = (bytes + UL_CACHE_LINE - 1) & ~(size_t)(UL_CACHE_LINE - 1);
+    ul_node_t *node = aligned_alloc(UL_CACHE_LINE, bytes);
+    DIE(node == NULL, "ul_node malloc");
+
+    node->next = NULL;
+    node->count = 0;
+    return node;
+}
+
+/*
+ * Gaseste nodul care contine pozitia n (0 <= n < size) si intoarce in *offset
+ * pozitia in cadrul nodului, iar in *prev nodul anterior (NULL pentru head).
+ */
+static ul_node_t*
+ul_find(linked_list_t* list, unsigned int n, unsigned int* offset,
+        ul_node_t** prev)
+{
+    ul_node_t *node = list->head;
+
+    *prev = NULL;
+    while (n >= node->count) {
+        n -= node->count;
+        *prev = node;
+        node = node->next;
+    }
+
+    *offset = n;
+    return node;
+}
+
+/*
+ * Pe baza datelor trimise prin pointerul new_data, se adauga o copie pe
+ * pozitia n a listei. Daca n >= nr_elemente, elementul se adauga la finalul
+ * listei, in O(1). Daca nodul in care ar trebui sa intre e plin, jumatate din
+ * elementele lui se muta intr-un nod nou, inserat imediat dupa el.
+ */
+void
+ll_add_nth_node(linked_list_t* list, unsigned int n, const void* new_data)
+{
+    ul_node_t *node, *prev;
+    unsigned int offset;
+
+    if (list == NULL)
+        return;
+
+    if (n >= list->size) {
+        if (list->tail == NULL || list->tail->count == list->per_node) {
+            node = ul_node_create(list);
+            if (list->tail == NULL)
+                list->head = node;
+            else
+                list->tail->next = node;
+            list->tail = node;
+        }
+        node = list->tail;
+        offset = node->count;
+    } else {
+        node = ul_find(list, n, &offset, &prev);
+
+        if (node->count == list->per_node) {
+            ul_node_t *half = ul_node_create(list);
+            unsigned int keep = node->count / 2;
+
+            half->count = node->count - keep;
+            memcpy(half->data, ul_elem(list, node, keep),
+                   (size_t)half->count * list->data_size);
+            node->count = keep;
+            half->next = node->next;
+            node->next = half;
+            if (list->tail == node)
+                list->tail = half;
+
+            if (offset > keep) {
+                offset -= keep;
+                node = half;
+            }
+        }
+
+        memmove(ul_elem(list, node, offset + 1), ul_elem(list, node, offset),
+                (size_t)(node->count - offset) * list->data_size);
+    }
+
+    memcpy(ul_elem(list, node, offset), new_data, list->data_size);
+    node->count++;
+    list->size++;
+}
+
+/*
+ * Elimina elementul de pe pozitia n din lista. Daca n >= nr_elemente - 1, se
+ * elimina ultimul element. Daca removed != NULL, elementul eliminat se copiaza
+ * acolo (data_size octeti). Un nod ramas gol se elibereaza, iar un nod ramas
+ * sub jumatate se uneste cu urmatorul daca incap impreuna, ca nodurile sa
+ * ramana in medie cel putin pe jumatate pline. Intoarce 0 daca s-a eliminat un
+ * element si -1 daca lista e goala.
+ */
+int
+ll_remove_nth_node(linked_list_t* list, unsigned int n, void* removed)
+{
+    ul_node_t *node, *prev;
+    unsigned int offset;
+
+    if (list == NULL || list->size == 0)
+        return -1;
+
+    if (n >= list->size)
+        n = list->size - 1;
+
+    node = ul_find(list, n, &offset, &prev);
+    if (removed != NULL)
+        memcpy(removed, ul_elem(list, node, offset), list->data_size);
+
+    memmove(ul_elem(list, node, offset), ul_elem(list, node, offset + 1),
+            (size_t)(node->count - offset - 1) * list->data_size);
+    node->count--;
+    list->size--;
+
+    if (node->count == 0) {
+        if (prev == NULL)
+            list->head = node->next;
+        else
+            prev->next = node->next;
+        if (list->tail == node)
+            list->tail = prev;
+        free(node);
+        return 0;
+    }
+
+    ul_node_t *next = node->next;
+    if (next != NULL && node->count < list->per_node / 2 &&
+        node->count + next->count <= list->per_node) {
+        memcpy(ul_elem(list, node, node->count), next->data,
+               (size_t)next->count * list->data_size);
+        node->count += next->count;
+        node->next = next->next;
+        if (list->tail == next)
+            list->tail = node;
+        free(next);
+    }
+
+    return 0;
+}
+
+void
+ll_push_front(linked_list_t* list, const void* new_data)
+{
+    ll_add_nth_node(list, 0, new_data);
+}
+
+void
+ll_push_back(linked_list_t* list, const void* new_data)
+{
+    ll_add_nth_node(list, list->size, new_data);
+}
+
+int
+ll_pop_front(linked_list_t* list, void* removed)
+{
+    return ll_remove_nth_node(list, 0, removed);
+}
+
+/*
+ * Functia intoarce numarul de elemente din lista al carei pointer este trimis
+ * ca parametru.
+ */
+unsigned int
+ll_get_size(linked_list_t* list)
+{
+    return list->size;
+}
+
+/*
+ * Procedura elibereaza memoria folosita de toate nodurile din lista, iar la
+ * sfarsit, elibereaza memoria folosita de structura lista si actualizeaza la
+ * NULL valoarea pointerului la care pointeaza argumentul. Elementele stau in
+ * noduri, deci e cate un free la per_node elemente.
+ */
+void
+ll_free(linked_list_t** pp_list)
+{
+	ul_node_t *travel = (*pp_list)->head;
+	while (travel != NULL) {
+		ul_node_t *temp = travel;
+		travel = travel->next;
+		free(temp);
+	}
+
+	free(*pp_list);
+	*pp_list = NULL;
+}
+
+/*
+ * Atentie! Aceasta functie poate fi apelata doar pe liste ale caror elemente
+ * STIM ca sunt int-uri. Functia afiseaza toate valorile separate printr-un
+ * spatiu.
+ */
+void
+ll_print_int(linked_list_t* list)
+{
+    for (ul_node_t *travel = list->head; travel != NULL; travel = travel->next) {
+        for (unsigned int i = 0; i < travel->count; ++i)
+            printf("%d ", *(int*)ul_elem(list, travel, i));
+    }
+    printf("\n");
+}
+
+/*
+ * Atentie! Aceasta functie poate fi apelata doar pe liste ale caror elemente
+ * STIM ca sunt string-uri. Functia afiseaza toate string-urile separate printr-un
+ * spatiu.
+ */
+void
+ll_print_string(linked_list_t* list)
+{
+    for (ul_node_t *travel = list->head; travel != NULL; travel = travel->next) {
+        for (unsigned int i = 0; i < travel->count; ++i)
+            printf("%s ", ul_elem(list, travel, i));
+    }
+    printf("\n");
+}
+
+int main()
+{
+    linked_list_t* linkedList;
+    int is_int = 0;
+    int is_string = 0;
+
+    while (1) {
+        char command[16], added_elem[64], *end_ptr;
+        long nr, pos;
+
+        if (scanf("%15s", command) != 1)
+            break;
+
+        if (strcmp(command, "create_str") == 0) {
+            linkedList = ll_create(MAX_STRING_SIZE);
+            is_string = 1;
+        }
+
+        if (strcmp(command, "create_int") == 0) {
+            linkedList = ll_create(sizeof(int));
+            is_int = 1;
+        }
+
+        if (strcmp(command, "add") == 0) {
+            scanf("%ld", &pos);
+            scanf("%63s", added_elem);
+
+            nr = strtol(added_elem, &end_ptr, 10);
+            if (nr != 0) {
+                ll_add_nth_node(linkedList, pos, &nr);
+            } else {
+                ll_add_nth_node(linkedList, pos, end_ptr);
+            }
+        }
+
+        if (strcmp(command, "push_front") == 0 ||
+            strcmp(command, "push_back") == 0) {
+            scanf("%63s", added_elem);
+
+            nr = strtol(added_elem, &end_ptr, 10);
+            void *data = nr != 0 ? (void *)&nr : (void *)end_ptr;
+            if (command[5] == 'f')
+                ll_push_front(linkedList, data);
+            else
+                ll_push_back(linkedList, data);
+        }
+
+        if (strcmp(command, "remove") == 0) {
+            scanf("%ld", &pos);
+            ll_remove_nth_node(linkedList, pos, NULL);
+        }
+
+        if (strcmp(command, "pop_front") == 0) {
+            ll_pop_front(linkedList, NULL);
+        }
+
+        if (strcmp(command, "print") == 0) {
+            if (is_int == 1) {
+                ll_print_int(linkedList);
+            }
+
+            if (is_string == 1) {
+                ll_print_string(linkedList);
+            }
+        }
+
+        if (strcmp(command, "free") == 0) {
+            ll_free(&linkedList);
+            break;
+        }
+    }
+
+    return 0;
+}
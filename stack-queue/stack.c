@@ -192,6 +192,10 @@ ll_print_string(linked_list_t* list)
 
 /* ---------------------------------- TODO: Stack implementation ----------------------------------------*/
 
+/*
+ * Varful stivei este capul listei: push, pop si peek lucreaza doar cu primul
+ * nod, deci sunt O(1) (adaugarea / eliminarea la final ar parcurge lista).
+ */
 struct Stack {
     linked_list_t *list;
 };
@@ -210,15 +214,11 @@ int is_empty_stack(struct Stack *stack) {
 }
 
 void* peek_stack(struct Stack *stack) {
-    if (stack == NULL || stack->list == NULL) {
+    if (stack == NULL || stack->list == NULL || stack->list->head == NULL) {
         return NULL;
     }
 
-    ll_node_t *node = stack->list->head;
-    while (node->next != NULL) {
-        node = node->next;
-    }
-    return node->data;
+    return stack->list->head->data;
 }
 
 void pop_stack(struct Stack *stack) {
@@ -228,18 +228,22 @@ void pop_stack(struct Stack *stack) {
         return;
     }
 
-    node = ll_remove_nth_node(stack->list, stack->list->size - 1);
-    free(node);
+    node = ll_remove_nth_node(stack->list, 0);
+    if (node != NULL) {
+        free(node->data);
+        free(node);
+    }
 }
 
 void push_stack(struct Stack *stack, void *new_data) {
-    ll_add_nth_node(stack->list, stack->list->size, new_data);
+    ll_add_nth_node(stack->list, 0, new_data);
 }
 
 void clear_stack(struct Stack *stack) {
     struct ll_node_t *node;
     while (!is_empty_stack(stack)) { //mod
         node = ll_remove_nth_node(stack->list, 0);
+        free(node->data);
         free(node);
     }
 }